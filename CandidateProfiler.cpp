@@ -0,0 +1,197 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   CandidateProfiler.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 11:52 PM
+ */
+
+#include "CandidateProfiler.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+    //One call in a candidate's tree, its total includes the calls made under it
+    struct Node {
+        const char* name;
+        int parent;
+        long long totalNanoseconds;
+        std::vector<int> children;
+    };
+    //The candidate being profiled on this thread, the profiler is NULL between candidates
+    struct ThreadProfile {
+        CandidateProfiler* profiler;
+        std::vector<Node> nodes;
+        int current;
+        //The candidate's entry in the profiler, other threads add theirs meanwhile
+        size_t candidate;
+        std::chrono::steady_clock::time_point startTime;
+    };
+    thread_local ThreadProfile threadProfile = { NULL, std::vector<Node>(), -1, 0,
+            std::chrono::steady_clock::time_point() };
+    
+    long long elapsedNanoseconds(std::chrono::steady_clock::time_point startTime) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+    }
+    
+    //';' separates the frames of a folded stack, so it can't be in a name
+    std::string frameName(const std::string& name) {
+        std::string frame = name;
+        std::replace(frame.begin(), frame.end(), ';', '_');
+        return frame;
+    }
+    
+    //Fold the tree under a node into stacks with the time spent in each call itself,
+    //keeping track of the call with the most of its own time
+    void foldNode(const std::vector<Node>& nodes, int index, const std::string& stack,
+            std::vector<std::pair<std::string, long long>>& stacks, int& slowest, long long& slowestSelf) {
+        const Node& node = nodes[index];
+        long long self = node.totalNanoseconds;
+        for (int child : node.children)
+            self -= nodes[child].totalNanoseconds;
+        self = std::max(self, 0LL);
+        if ((index > 0) && (self > slowestSelf)) {
+            slowest = index;
+            slowestSelf = self;
+        }
+        stacks.push_back(std::make_pair(stack, self));
+        for (int child : node.children)
+            foldNode(nodes, child, stack + ";" + nodes[child].name, stacks, slowest, slowestSelf);
+    }
+}
+
+CandidateProfiler::Scope::Scope(const char* name) : node(-1) {
+    ThreadProfile& profile = threadProfile;
+    if (profile.profiler == NULL)
+        return;
+    //A call made again from the same place adds to the same node
+    for (int child : profile.nodes[profile.current].children)
+        if (!strcmp(profile.nodes[child].name, name)) {
+            this->node = child;
+            break;
+        }
+    if (this->node < 0) {
+        this->node = profile.nodes.size();
+        Node added = { name, profile.current, 0, std::vector<int>() };
+        profile.nodes.push_back(added);
+        profile.nodes[profile.current].children.push_back(this->node);
+    }
+    profile.current = this->node;
+    this->startTime = std::chrono::steady_clock::now();
+}
+
+CandidateProfiler::Scope::~Scope() {
+    if (this->node < 0)
+        return;
+    ThreadProfile& profile = threadProfile;
+    profile.nodes[this->node].totalNanoseconds += elapsedNanoseconds(this->startTime);
+    profile.current = profile.nodes[this->node].parent;
+}
+
+CandidateProfiler::CandidateProfiler() {};
+
+//Start timing a candidate on this thread, its calls are recorded until endCandidate
+void CandidateProfiler::beginCandidate(const std::string& filePath, int lineNumber) {
+    ThreadProfile& profile = threadProfile;
+    profile.profiler = this;
+    profile.nodes.clear();
+    Node root = { "", -1, 0, std::vector<int>() };
+    profile.nodes.push_back(root);
+    profile.current = 0;
+    profile.startTime = std::chrono::steady_clock::now();
+    Candidate candidate = { filePath, lineNumber, 0, "", 0 };
+    std::lock_guard<std::mutex> guard(this->lock);
+    profile.candidate = this->candidates.size();
+    this->candidates.push_back(candidate);
+}
+
+//Stop timing this thread's candidate and fold its calls in with the others
+void CandidateProfiler::endCandidate() {
+    ThreadProfile& profile = threadProfile;
+    if (profile.profiler != this)
+        return;
+    profile.profiler = NULL;
+    profile.nodes[0].totalNanoseconds = elapsedNanoseconds(profile.startTime);
+    std::vector<std::pair<std::string, long long>> stacks;
+    int slowest = 0;
+    long long slowestSelf = 0;
+    std::lock_guard<std::mutex> guard(this->lock);
+    Candidate& candidate = this->candidates[profile.candidate];
+    //The candidate's frame sits under its file's, so a flame graph groups a file's candidates
+    std::string root = frameName(candidate.filePath) + ";line " + std::to_string(candidate.lineNumber);
+    foldNode(profile.nodes, 0, root, stacks, slowest, slowestSelf);
+    for (const std::pair<std::string, long long>& stack : stacks)
+        this->foldedStacks[stack.first] += stack.second;
+    candidate.totalNanoseconds = profile.nodes[0].totalNanoseconds;
+    candidate.slowestFrame = (slowest > 0) ? profile.nodes[slowest].name : "";
+    candidate.slowestSelfNanoseconds = slowestSelf;
+}
+
+//Write one "frame;frame;frame microseconds" line per stack, the input flamegraph.pl takes
+bool CandidateProfiler::writeFoldedStacks(const std::string& outputPath) {
+    std::ofstream output(outputPath.c_str());
+    if (!output.is_open())
+        return false;
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (const std::pair<const std::string, long long>& stack : this->foldedStacks) {
+        long long microseconds = (stack.second + 500) / 1000;
+        if (microseconds > 0)
+            output << stack.first << " " << microseconds << "\n";
+    }
+    output.close();
+    return !output.fail();
+}
+
+//List the candidates that took longest, with the call that took most of it
+void CandidateProfiler::writeSlowest(std::ostream& output, size_t count) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::vector<const Candidate*> slowest;
+    for (const Candidate& candidate : this->candidates)
+        slowest.push_back(&candidate);
+    count = std::min(count, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+            [](const Candidate* first, const Candidate* second) {
+        return first->totalNanoseconds > second->totalNanoseconds;
+    });
+    output << "\nSlowest Candidates:" << std::endl;
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::right << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < count; i++) {
+        const Candidate& candidate = *slowest[i];
+        output << std::setw(10) << candidate.totalNanoseconds / 1e6 << " ms  " <<
+                candidate.filePath << ":" << candidate.lineNumber;
+        if (!candidate.slowestFrame.empty())
+            output << "  (" << candidate.slowestFrame << " " <<
+                    candidate.slowestSelfNanoseconds / 1e6 << " ms self)";
+        output << std::endl;
+    }
+    output.flags(flags);
+    output.precision(precision);
+}
@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   CandidateProfiler.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 11:52 PM
+ */
+
+#ifndef CANDIDATEPROFILER_H
+#define CANDIDATEPROFILER_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Times the parser calls each candidate makes as a tree, so the expensive candidates
+//and the calls they spend it in can be found. A thread profiles one candidate at a
+//time, the finished trees are folded into stacks shared by all of the threads.
+class CandidateProfiler {
+public:
+    //Marks one call on the current thread's candidate for as long as it's in scope,
+    //without a candidate being profiled on the thread it does nothing
+    class Scope {
+    public:
+        Scope(const char* name);
+        ~Scope();
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        int node;
+        std::chrono::steady_clock::time_point startTime;
+    };
+    CandidateProfiler();
+    void beginCandidate(const std::string& filePath, int lineNumber);
+    void endCandidate();
+    bool writeFoldedStacks(const std::string& outputPath);
+    void writeSlowest(std::ostream& output, size_t count);
+private:
+    CandidateProfiler(const CandidateProfiler&);
+    CandidateProfiler& operator=(const CandidateProfiler&);
+    struct Candidate {
+        std::string filePath;
+        int lineNumber;
+        long long totalNanoseconds;
+        //The call with the most time of its own and how much
+        std::string slowestFrame;
+        long long slowestSelfNanoseconds;
+    };
+    std::mutex lock;
+    //Self time in nanoseconds by the stack of calls, from the candidate down
+    std::map<std::string, long long> foldedStacks;
+    std::vector<Candidate> candidates;
+};
+
+#endif /* CANDIDATEPROFILER_H */
@@ -0,0 +1,211 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ConsistencyCheck.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 9:40 AM
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "StructuralIndex.h"
+
+//Writes a generated project with its grep input, and checks the structural scan gives
+//the same lines with and without SSE2 over those files and over random text.
+//make check runs it, then compares scans of the project at different -j.
+
+//A fixed sequence of numbers, so every run checks the same files
+static unsigned long randomState = 1;
+
+static int nextRandom(int range) {
+    randomState = randomState * 6364136223846793005UL + 1442695040888963407UL;
+    return (int)((randomState >> 33) % range);
+}
+
+//One method, drawn from the shapes the parser handles: literals, locals, parameters,
+//helpers of this class, arrays, comments and text that looks like structure
+static std::string makeMethod(int method, int candidates, const std::string& indent) {
+    std::ostringstream body;
+    body << indent << "public void method" << method << "(String arg, String[] args) throws Exception {\n";
+    body << indent << indent << "String local = \"echo {" << method << "}\";\n";
+    body << indent << indent << "String joined = local + arg;\n";
+    for (int i = 0; i < candidates; i++) {
+        body << indent << indent;
+        switch (nextRandom(10)) {
+            case 0: body << "Runtime.getRuntime().exec(\"ls /tmp/" << i << "\");"; break;
+            case 1: body << "Runtime.getRuntime().exec(local);"; break;
+            case 2: body << "Runtime.getRuntime().exec(joined);"; break;
+            case 3: body << "Runtime.getRuntime().exec(arg);"; break;
+            case 4: body << "Runtime.getRuntime().exec(build(arg));"; break;
+            case 5: body << "Runtime.getRuntime().exec(new String[] {\"sh\", \"-c\", local});"; break;
+            case 6: body << "// Runtime.getRuntime().exec(arg);"; break;
+            case 7: body << "Runtime.getRuntime().exec(COMMAND + \" été (\");"; break;
+            case 8: body << "Runtime.getRuntime().exec(args);"; break;
+            default: body << "run(local, '{');"; break;
+        }
+        body << "\n";
+    }
+    body << indent << indent << "/* Runtime.getRuntime().exec(local);\n";
+    body << indent << indent << " * } still a comment */\n";
+    body << indent << "}\n\n";
+    return body.str();
+}
+
+//A class of several methods, with members, a constructor, helpers and an inner class
+static std::string makeJavaFile(const std::string& className, int fileNumber, int methods, int candidates) {
+    std::string indent = (fileNumber % 3 == 0) ? "\t" : "    ";
+    std::ostringstream file;
+    file << "package check;\n\n// A comment with a { in it\n";
+    file << "public class " << className << " {\n";
+    file << indent << "private static final String COMMAND = \"date }\";\n";
+    file << indent << "private String command = \"ls\";\n\n";
+    file << indent << "public " << className << "(String command) {\n";
+    file << indent << indent << "this.command = command;\n" << indent << "}\n\n";
+    file << indent << "private String build(String a) {\n";
+    file << indent << indent << "return a + \"/tmp\";\n" << indent << "}\n\n";
+    file << indent << "private void run(String cmd, char c) throws Exception {\n";
+    file << indent << indent << "Runtime.getRuntime().exec(cmd);\n" << indent << "}\n\n";
+    for (int method = 0; method < methods; method++)
+        file << makeMethod(method, candidates, indent);
+    file << indent << "class Inner {\n";
+    file << indent << indent << "void go(String x) throws Exception { Runtime.getRuntime().exec(x); }\n";
+    file << indent << "}\n}\n";
+    std::string text = file.str();
+    //Some files have Windows line endings
+    if (fileNumber % 4 == 1) {
+        std::string crlf;
+        for (char c : text) {
+            if (c == '\n')
+                crlf += '\r';
+            crlf += c;
+        }
+        text.swap(crlf);
+    }
+    return text;
+}
+
+//Text made of the characters the scan looks for, so markers land on every block boundary
+static std::string makeRandomText(int length) {
+    static const char characters[] = "{}()/*\n \t\"';ab\r\xc3\xa9";
+    std::string text;
+    for (int i = 0; i < length; i++)
+        text += characters[nextRandom(sizeof(characters) - 1)];
+    return text;
+}
+
+static bool sameLine(const StructuralIndex::Line& left, const StructuralIndex::Line& right) {
+    return (left.openBraces == right.openBraces) && (left.closeBraces == right.closeBraces) &&
+            (left.hasParenthesis == right.hasParenthesis) && (left.hasLineComment == right.hasLineComment) &&
+            (left.startsAsComment == right.startsAsComment) && (left.lastCommentOpen == right.lastCommentOpen) &&
+            (left.lastCommentClose == right.lastCommentClose);
+}
+
+//Scan the text with and without SSE2, in one go and in chunks the way JavaReader asks,
+//false with a message on the first line that differs
+static bool checkStructure(const std::string& name, const std::string& text) {
+    std::vector<int> lineStarts[2];
+    std::vector<StructuralIndex::Line> lines[3];
+    for (int vectorized = 0; vectorized < 2; vectorized++) {
+        StructuralIndex::setVectorized(vectorized);
+        StructuralIndex::findLineStarts(text.data(), text.size(), lineStarts[vectorized]);
+        StructuralIndex::scanLines(text.data(), text.size(), lineStarts[vectorized].data(),
+                lineStarts[vectorized].size(), lineStarts[vectorized].size(), lines[vectorized]);
+    }
+    StructuralIndex::setVectorized(true);
+    for (int lastLine = 7; lines[2].size() < lineStarts[1].size(); lastLine += 7)
+        StructuralIndex::scanLines(text.data(), text.size(), lineStarts[1].data(), lineStarts[1].size(),
+                lastLine, lines[2]);
+    if (lineStarts[0] != lineStarts[1]) {
+        std::cerr << name << ": line starts differ between the scalar and SSE2 scans\n";
+        return false;
+    }
+    for (int scan = 1; scan < 3; scan++) {
+        if (lines[scan].size() != lines[0].size()) {
+            std::cerr << name << ": " << lines[scan].size() << " lines scanned instead of " << lines[0].size() << "\n";
+            return false;
+        }
+        for (size_t i = 0; i < lines[0].size(); i++) {
+            if (!sameLine(lines[0][i], lines[scan][i])) {
+                std::cerr << name << ": line " << (i + 1) << " differs between the scalar and "
+                        << ((scan == 1) ? "SSE2" : "chunked SSE2") << " scans\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string projectPath = "check_project";
+    int fileCount = 40;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-p") && (i + 1 < argc))
+            projectPath = argv[++i];
+        else if (!strcmp(argv[i], "--files") && (i + 1 < argc))
+            fileCount = atoi(argv[++i]);
+        else {
+            std::cout << "Usage: consistency_check [-p project_path] [--files count]" << std::endl;
+            return (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-?")) ? 0 : 1;
+        }
+    }
+    mkdir(projectPath.c_str(), 0755);
+    std::ofstream grep(projectPath + "/grep.txt", std::ios::trunc);
+    int failures = 0;
+    for (int fileNumber = 0; fileNumber < fileCount; fileNumber++) {
+        //The last file is one big one with more candidates than a thread should have alone
+        bool big = (fileNumber == fileCount - 1);
+        //Numbered so the grep input lists the files in path order, the same order streaming reads them
+        char className[32];
+        snprintf(className, sizeof(className), "Check%04d", fileNumber);
+        std::string fileName = std::string(className) + ".java";
+        std::string text = makeJavaFile(className, fileNumber, big ? 12 : 1 + nextRandom(6), big ? 40 : 1 + nextRandom(8));
+        std::ofstream(projectPath + "/" + fileName, std::ios::binary | std::ios::trunc) << text;
+        //The same lines grep -n "\.exec(" would give
+        std::istringstream lines(text);
+        std::string line;
+        for (int lineNumber = 1; std::getline(lines, line); lineNumber++)
+            if (line.find(".exec(") != std::string::npos)
+                grep << "./" << fileName << ":" << lineNumber << ":" << line << "\n";
+        if (!checkStructure(fileName, text))
+            failures++;
+    }
+    for (int i = 0; i < 200; i++)
+        if (!checkStructure("random text " + std::to_string(i), makeRandomText(1 + nextRandom(600))))
+            failures++;
+    if (!grep) {
+        std::cerr << "Error: could not write " << projectPath << "\n";
+        return 1;
+    }
+    std::cout << "Structural scan: " << (fileCount + 200) << " texts, " << failures << " differ" << std::endl;
+    return failures ? 1 : 0;
+}
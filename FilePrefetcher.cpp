@@ -0,0 +1,162 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FilePrefetcher.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#include "FilePrefetcher.h"
+#include "ZipArchive.h"
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//More readers than this just fight over the same disk
+static const int maxReaders = 4;
+
+//A depth of 0 reads every file synchronously when it is taken
+FilePrefetcher::FilePrefetcher(int depth) : depth(depth), stopping(false),
+        takeCount(0), starvedCount(0), starvedSeconds(0) {
+    int readerCount = std::min(depth, maxReaders);
+    for (int i = 0; i < readerCount; i++)
+        this->readers.push_back(std::thread(&FilePrefetcher::readLoop, this));
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->requested.notify_all();
+    for (std::thread& reader : this->readers)
+        reader.join();
+}
+
+int FilePrefetcher::getDepth() {
+    return this->depth;
+}
+
+//Queue a file to be read, files must be taken in the order they were requested
+void FilePrefetcher::request(const std::string& filePath) {
+    std::shared_ptr<Entry> entry(new Entry());
+    entry->filePath = filePath;
+    entry->ready = false;
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->entries.push_back(entry);
+    if (!this->readers.empty()) {
+        this->unread.push_back(entry);
+        this->requested.notify_one();
+    }
+}
+
+std::string FilePrefetcher::take(const std::string& filePath) {
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->takeCount++;
+    //Files that were never requested are just read here
+    if (this->entries.empty() || (this->entries.front()->filePath != filePath)) {
+        guard.unlock();
+        return FilePrefetcher::readFile(filePath);
+    }
+    std::shared_ptr<Entry> entry = this->entries.front();
+    this->entries.pop_front();
+    //Without readers there is nobody to wait for, so read it now
+    if (this->readers.empty()) {
+        guard.unlock();
+        return FilePrefetcher::readFile(filePath);
+    }
+    //If the readers haven't got to it yet, the analysis is starved for input
+    if (!entry->ready) {
+        this->starvedCount++;
+        std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+        while (!entry->ready)
+            this->finished.wait(guard);
+        this->starvedSeconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - waitStart).count();
+    }
+    std::string contents;
+    contents.swap(entry->contents);
+    return contents;
+}
+
+long FilePrefetcher::getTakeCount() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->takeCount;
+}
+
+long FilePrefetcher::getStarvedCount() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->starvedCount;
+}
+
+double FilePrefetcher::getStarvedSeconds() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->starvedSeconds;
+}
+
+//Read a whole file or archive member into a string, empty if it can't be opened
+std::string FilePrefetcher::readFile(const std::string& filePath) {
+    std::string contents;
+    //Archive members are inflated in memory instead of being extracted first
+    if (ZipArchive::readFile(filePath, contents))
+        return contents;
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return contents;
+    //Tell the kernel the whole file is wanted so it reads ahead in one go
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        contents.reserve(fileStat.st_size);
+    }
+    char block[65536];
+    ssize_t count;
+    while ((count = read(fd, block, sizeof(block))) > 0)
+        contents.append(block, count);
+    close(fd);
+    return contents;
+}
+
+void FilePrefetcher::readLoop() {
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (true) {
+        while (this->unread.empty() && !this->stopping)
+            this->requested.wait(guard);
+        if (this->stopping)
+            return;
+        std::shared_ptr<Entry> entry = this->unread.front();
+        this->unread.pop_front();
+        //Do the actual I/O without holding the lock
+        guard.unlock();
+        std::string contents = FilePrefetcher::readFile(entry->filePath);
+        guard.lock();
+        entry->contents.swap(contents);
+        entry->ready = true;
+        this->finished.notify_all();
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FilePrefetcher.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef FILEPREFETCHER_H
+#define FILEPREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Reads upcoming source files on background threads so analysis gets ready buffers
+class FilePrefetcher {
+public:
+    FilePrefetcher(int depth);
+    ~FilePrefetcher();
+    int getDepth();
+    void request(const std::string& filePath);
+    std::string take(const std::string& filePath);
+    long getTakeCount();
+    long getStarvedCount();
+    double getStarvedSeconds();
+    static std::string readFile(const std::string& filePath);
+private:
+    struct Entry {
+        std::string filePath;
+        std::string contents;
+        bool ready;
+    };
+    FilePrefetcher(const FilePrefetcher&);
+    FilePrefetcher& operator=(const FilePrefetcher&);
+    void readLoop();
+    int depth;
+    bool stopping;
+    long takeCount;
+    long starvedCount;
+    double starvedSeconds;
+    std::deque<std::shared_ptr<Entry>> entries;
+    std::deque<std::shared_ptr<Entry>> unread;
+    std::vector<std::thread> readers;
+    std::mutex lock;
+    std::condition_variable requested;
+    std::condition_variable finished;
+};
+
+#endif /* FILEPREFETCHER_H */
@@ -0,0 +1,119 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FileScheduler.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 19, 2026, 12:41 AM
+ */
+
+#include "FileScheduler.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//A candidate costs about as much as indexing this many bytes of source
+static const double candidateBytes = 4096.0;
+
+FileScheduler::FileScheduler() {};
+
+//Read the timings a previous run saved, a missing file just leaves nothing to go on
+//Each line is the seconds a file took and then its path
+bool FileScheduler::loadTimings(const std::string& timingsPath) {
+    std::ifstream input(timingsPath);
+    if (!input)
+        return false;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        double seconds;
+        std::string filePath;
+        if (!(fields >> seconds) || (fields.get() != ' ') || !std::getline(fields, filePath))
+            continue;
+        this->timings[filePath] = seconds;
+    }
+    return true;
+}
+
+//Write every timing, the ones loaded and not measured again included
+//It's written next to the destination and renamed over it like a snapshot
+bool FileScheduler::saveTimings(const std::string& timingsPath) const {
+    std::string temporaryPath = timingsPath + ".tmp";
+    std::ofstream output(temporaryPath, std::ios::trunc);
+    if (!output)
+        return false;
+    for (const std::pair<const std::string, double>& timing : this->timings)
+        output << timing.second << " " << timing.first << "\n";
+    output.close();
+    if (!output || (rename(temporaryPath.c_str(), timingsPath.c_str()) != 0)) {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FileScheduler::recordTiming(const std::string& filePath, double seconds) {
+    this->timings[filePath] = seconds;
+}
+
+//Give the order to dispatch the jobs in, most expensive first and by path between equals.
+//Files that were timed before use their timing, the rest are estimated and the estimates
+//are put in seconds by how the timed files' estimates compared with their timings.
+std::vector<size_t> FileScheduler::order(const std::vector<Job>& jobs) const {
+    std::vector<double> costs(jobs.size());
+    std::vector<bool> timed(jobs.size(), false);
+    double timedSeconds = 0;
+    double timedEstimate = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        costs[i] = estimateCost(jobs[i]);
+        std::map<std::string, double>::const_iterator timing = this->timings.find(jobs[i].filePath);
+        if (timing != this->timings.end()) {
+            timed[i] = true;
+            timedSeconds += timing->second;
+            timedEstimate += costs[i];
+            costs[i] = timing->second;
+        }
+    }
+    double secondsPerCost = ((timedSeconds > 0) && (timedEstimate > 0)) ? timedSeconds / timedEstimate : 1;
+    for (size_t i = 0; i < jobs.size(); i++)
+        if (!timed[i])
+            costs[i] *= secondsPerCost;
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t first, size_t second) {
+        if (costs[first] != costs[second])
+            return costs[first] > costs[second];
+        return jobs[first].filePath < jobs[second].filePath;
+    });
+    return order;
+}
+
+//Indexing grows with the file and each candidate adds its own analysis
+double FileScheduler::estimateCost(const Job& job) {
+    return job.fileSize + job.candidateCount * candidateBytes;
+}
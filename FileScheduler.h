@@ -0,0 +1,61 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FileScheduler.h
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 12:41 AM
+ */
+
+#ifndef FILESCHEDULER_H
+#define FILESCHEDULER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+//Orders files for the analysis threads longest first, so a big file doesn't start
+//last and hold up the end of the scan. A file's cost is estimated from its size and
+//candidate count, or from how long it took on a run whose timings were saved.
+class FileScheduler {
+public:
+    //A file waiting to be analyzed, with what its cost is estimated from
+    struct Job {
+        std::string filePath;
+        size_t fileSize;
+        size_t candidateCount;
+    };
+    FileScheduler();
+    bool loadTimings(const std::string& timingsPath);
+    bool saveTimings(const std::string& timingsPath) const;
+    void recordTiming(const std::string& filePath, double seconds);
+    std::vector<size_t> order(const std::vector<Job>& jobs) const;
+private:
+    static double estimateCost(const Job& job);
+    //Seconds each file took to analyze, by its path in the project
+    std::map<std::string, double> timings;
+};
+
+#endif /* FILESCHEDULER_H */
@@ -0,0 +1,183 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FileWatcher.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 10:24 PM
+ */
+
+#include "FileWatcher.h"
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "Utility.h"
+
+//Editors save in bursts (write, rename, chmod), wait this long for the burst to end
+static const int settleMilliseconds = 50;
+
+static const uint32_t watchedEvents = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+        IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+
+//Watch the whole tree now, the .java files found on the way are the initial scan
+FileWatcher::FileWatcher(const std::string& rootPath) : rootPath(rootPath) {
+    this->fd = inotify_init1(IN_CLOEXEC);
+    if (this->fd < 0)
+        return;
+    this->addDirectory("", this->javaFiles);
+    this->trackedFiles.insert(this->javaFiles.begin(), this->javaFiles.end());
+}
+
+FileWatcher::~FileWatcher() {
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+bool FileWatcher::isOpen() const {
+    return (this->fd >= 0);
+}
+
+const std::vector<std::string>& FileWatcher::getJavaFiles() const {
+    return this->javaFiles;
+}
+
+//Block until something changes, then collect everything that changes with it
+bool FileWatcher::waitForChanges(std::set<std::string>& changedFiles, std::set<std::string>& removedFiles) {
+    changedFiles.clear();
+    removedFiles.clear();
+    struct pollfd watch = { this->fd, POLLIN, 0 };
+    while (changedFiles.empty() && removedFiles.empty()) {
+        if (poll(&watch, 1, -1) < 0)
+            return false;
+        if (!this->readEvents(changedFiles, removedFiles))
+            return false;
+        while (poll(&watch, 1, settleMilliseconds) > 0)
+            if (!this->readEvents(changedFiles, removedFiles))
+                return false;
+    }
+    return true;
+}
+
+void FileWatcher::addDirectory(const std::string& relativePath, std::vector<std::string>& javaFiles) {
+    std::string fullPath = this->rootPath + "/" + relativePath;
+    int watch = inotify_add_watch(this->fd, fullPath.c_str(), watchedEvents | IN_ONLYDIR);
+    if (watch < 0)
+        return;
+    this->directories[watch] = relativePath;
+    DIR* directory = opendir(fullPath.c_str());
+    if (directory == NULL)
+        return;
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        std::string name = entry->d_name;
+        if ((name == ".") || (name == ".."))
+            continue;
+        std::string entryPath = relativePath.empty() ? name : relativePath + "/" + name;
+        if (entry->d_type == DT_DIR)
+            this->addDirectory(entryPath, javaFiles);
+        else if (Util::endsWith(name, ".java"))
+            javaFiles.push_back(entryPath);
+    }
+    closedir(directory);
+}
+
+//A directory moved away or deleted takes every file under it along, and its watches
+//and those of its subdirectories go with it, they'd report under the old path otherwise
+void FileWatcher::removeDirectory(const std::string& relativePath, std::set<std::string>& changedFiles,
+        std::set<std::string>& removedFiles) {
+    std::string prefix = relativePath.empty() ? relativePath : relativePath + "/";
+    std::set<std::string>::iterator file = this->trackedFiles.lower_bound(prefix);
+    while ((file != this->trackedFiles.end()) && Util::startsWith(*file, prefix)) {
+        removedFiles.insert(*file);
+        changedFiles.erase(*file);
+        file = this->trackedFiles.erase(file);
+    }
+    std::map<int, std::string>::iterator directory = this->directories.begin();
+    while (directory != this->directories.end()) {
+        if ((directory->second == relativePath) || Util::startsWith(directory->second, prefix)) {
+            inotify_rm_watch(this->fd, directory->first);
+            directory = this->directories.erase(directory);
+        }
+        else {
+            directory++;
+        }
+    }
+}
+
+bool FileWatcher::readEvents(std::set<std::string>& changedFiles, std::set<std::string>& removedFiles) {
+    alignas(struct inotify_event) char events[65536];
+    ssize_t length = read(this->fd, events, sizeof(events));
+    if (length <= 0)
+        return false;
+    for (ssize_t offset = 0; offset < length;) {
+        const struct inotify_event* event = (const struct inotify_event*)(events + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+        std::map<int, std::string>::iterator directory = this->directories.find(event->wd);
+        if (directory == this->directories.end())
+            continue;
+        if (event->mask & IN_DELETE_SELF) {
+            this->removeDirectory(directory->second, changedFiles, removedFiles);
+            continue;
+        }
+        if (event->mask & IN_IGNORED) {
+            this->directories.erase(directory);
+            continue;
+        }
+        if (event->len == 0)
+            continue;
+        std::string name = event->name;
+        std::string entryPath = directory->second.empty() ? name : directory->second + "/" + name;
+        //New directories are watched too, and anything already in them counts as changed.
+        //A renamed directory is a move from the old path and a move to the new one
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                this->removeDirectory(entryPath, changedFiles, removedFiles);
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                std::vector<std::string> newFiles;
+                this->addDirectory(entryPath, newFiles);
+                for (const std::string& newFile : newFiles) {
+                    changedFiles.insert(newFile);
+                    removedFiles.erase(newFile);
+                }
+                this->trackedFiles.insert(newFiles.begin(), newFiles.end());
+            }
+            continue;
+        }
+        if (!Util::endsWith(name, ".java"))
+            continue;
+        if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+            removedFiles.insert(entryPath);
+            changedFiles.erase(entryPath);
+            this->trackedFiles.erase(entryPath);
+        }
+        else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+            changedFiles.insert(entryPath);
+            removedFiles.erase(entryPath);
+            this->trackedFiles.insert(entryPath);
+        }
+    }
+    return true;
+}
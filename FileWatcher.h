@@ -0,0 +1,64 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   FileWatcher.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:24 PM
+ */
+
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+//Watches every directory under a root with inotify and reports the .java files
+//that were written, created, moved or deleted, as paths relative to the root
+class FileWatcher {
+public:
+    FileWatcher(const std::string& rootPath);
+    ~FileWatcher();
+    bool isOpen() const;
+    const std::vector<std::string>& getJavaFiles() const;
+    bool waitForChanges(std::set<std::string>& changedFiles, std::set<std::string>& removedFiles);
+private:
+    FileWatcher(const FileWatcher&);
+    FileWatcher& operator=(const FileWatcher&);
+    void addDirectory(const std::string& relativePath, std::vector<std::string>& javaFiles);
+    void removeDirectory(const std::string& relativePath, std::set<std::string>& changedFiles,
+            std::set<std::string>& removedFiles);
+    bool readEvents(std::set<std::string>& changedFiles, std::set<std::string>& removedFiles);
+    std::string rootPath;
+    int fd;
+    std::map<int, std::string> directories;
+    std::vector<std::string> javaFiles;
+    //Every .java file currently in the tree, so a directory that goes takes its files with it
+    std::set<std::string> trackedFiles;
+};
+
+#endif /* FILEWATCHER_H */
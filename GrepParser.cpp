@@ -30,11 +30,15 @@
  */
 
 #include "GrepParser.h"
+#include <algorithm>
 
-GrepParser::GrepParser() : input(&std::cin) {};
+//Most slots the streamed paths' hashes take, 8 MB, they're only filled up to three quarters
+static const size_t maxPathSlots = 1 << 20;
+
+GrepParser::GrepParser() : input(&std::cin), pathCount(0), skippedRuns(0), uncheckedFiles(0) {};
 
 GrepParser::GrepParser(const std::string& filePath) :
-    input(new std::ifstream(filePath)) {};
+    input(new std::ifstream(filePath)), pathCount(0), skippedRuns(0), uncheckedFiles(0) {};
     
 GrepParser::~GrepParser() {
     if (this->input != &std::cin)
@@ -48,22 +52,40 @@ void GrepParser::setInput(const std::string& filePath) {
     this->input = new std::ifstream(filePath);
 }
 
+//Reads grep output that was already read into memory, such as piped input used twice
+void GrepParser::setInputText(const std::string& text) {
+    if (this->input != &std::cin)
+        delete this->input;
+    this->input = new std::istringstream(text);
+}
+
+//Split a grep line into its file path and line number, false if malformed
+bool GrepParser::parseLine(const std::string& line, std::string& filePath, int& lineNumber) {
+    //Format is [file path]:[line number]:[line content] so split on ":"
+    size_t firstColon = line.find(":");
+    if (firstColon == std::string::npos)
+        return false;
+    size_t secondColon = line.find(":", firstColon + 1);
+    filePath = line.substr(0, firstColon);
+    //Remove "./" from beginning of file name if it exists there
+    if (!filePath.substr(0,2).compare("./"))
+        filePath = filePath.substr(2);
+    //Parse the number and convert it to an integer
+    std::string lineString = line.substr(firstColon+1, secondColon-firstColon);
+    lineNumber = stoi(lineString);
+    return true;
+}
+
 //Return a map between all file paths and the line numbers specified by grep
 std::map<std::string, std::vector<int>> GrepParser::parseInput() {
     std::map<std::string, std::vector<int>> fileLines;
     std::string line;
+    std::string filePath;
+    int lineNumber;
     //Read through until the eof
     while(getline(*this->input, line)) {
-        //Format is [file path]:[line number]:[line content] so split on ":"
-        size_t firstColon = line.find(":");
-        size_t secondColon = line.find(":", firstColon + 1);
-        std::string filePath = line.substr(0, firstColon);
-        //Remove "./" from beginning of file name if it exists there
-        if (!filePath.substr(0,2).compare("./"))
-            filePath = filePath.substr(2);
-        //Parse the number and convert it to an integer
-        std::string lineString = line.substr(firstColon+1, secondColon-firstColon);
-        int lineNumber = stoi(lineString);
+        if (!GrepParser::parseLine(line, filePath, lineNumber))
+            continue;
         //If file path is not in the map yet, create a new vector it
         if (!fileLines.count(filePath)) {
             std::vector<int> newFile;
@@ -78,3 +100,124 @@ std::map<std::string, std::vector<int>> GrepParser::parseInput() {
     }
     return fileLines;
 }
+
+//Read the next run of lines for a single file, so the whole map is never resident
+//grep prints every match of a file together, so a change in path ends the file.
+//Input that isn't grouped by file can't be streamed, a later run of a file that was
+//already returned would scan and count it twice, so it's skipped and counted instead
+bool GrepParser::parseNextFile(std::string& filePath, std::vector<int>& lineNumbers) {
+    while (true) {
+        lineNumbers.clear();
+        if (!this->parseNextRun(filePath, lineNumbers))
+            return false;
+        if (this->rememberPath(filePath))
+            return true;
+        this->skippedRuns++;
+    }
+}
+
+//Runs of files parseNextFile skipped because the file had already been returned
+int GrepParser::getSkippedRunCount() const {
+    return this->skippedRuns;
+}
+
+//Files parseNextFile returned after the path hashes were full, a later run of them isn't caught
+int GrepParser::getUncheckedFileCount() const {
+    return this->uncheckedFiles;
+}
+
+//Add the path's hash, false if it was there already. Two paths sharing a 64 bit hash
+//would have the second's lines skipped, which is too unlikely to keep the paths for.
+//Once the table is as big as it gets, new paths are let through without being added.
+bool GrepParser::rememberPath(const std::string& filePath) {
+    //FNV-1a, with 0 left to mark an empty slot
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : filePath) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ULL;
+    }
+    if (hash == 0)
+        hash = 1;
+    if ((this->pathCount + 1) * 4 > this->pathHashes.size() * 3) {
+        if (this->pathHashes.size() < maxPathSlots) {
+            //Grow and put the hashes back in their new slots
+            std::vector<uint64_t> oldHashes(std::max<size_t>(1024, this->pathHashes.size() * 2), 0);
+            oldHashes.swap(this->pathHashes);
+            for (uint64_t oldHash : oldHashes) {
+                if (oldHash == 0)
+                    continue;
+                size_t slot = oldHash & (this->pathHashes.size() - 1);
+                while (this->pathHashes[slot] != 0)
+                    slot = (slot + 1) & (this->pathHashes.size() - 1);
+                this->pathHashes[slot] = oldHash;
+            }
+        }
+    }
+    size_t slot = hash & (this->pathHashes.size() - 1);
+    while (this->pathHashes[slot] != 0) {
+        if (this->pathHashes[slot] == hash)
+            return false;
+        slot = (slot + 1) & (this->pathHashes.size() - 1);
+    }
+    //Full, it can still be told apart from the paths already in but isn't added
+    if ((this->pathCount + 1) * 4 > this->pathHashes.size() * 3) {
+        this->uncheckedFiles++;
+        return true;
+    }
+    this->pathHashes[slot] = hash;
+    this->pathCount++;
+    return true;
+}
+
+bool GrepParser::parseNextRun(std::string& filePath, std::vector<int>& lineNumbers) {
+    std::string line;
+    std::string linePath;
+    int lineNumber;
+    //Start with the line that ended the previous file, if there was one
+    if (!this->pendingLine.empty()) {
+        line.swap(this->pendingLine);
+        if (GrepParser::parseLine(line, linePath, lineNumber)) {
+            filePath = linePath;
+            lineNumbers.push_back(lineNumber);
+        }
+    }
+    while (getline(*this->input, line)) {
+        if (!GrepParser::parseLine(line, linePath, lineNumber))
+            continue;
+        //The first line read decides which file this is
+        if (lineNumbers.empty())
+            filePath = linePath;
+        //A new path belongs to the next file, so hold on to it for later
+        else if (linePath != filePath) {
+            this->pendingLine = line;
+            break;
+        }
+        lineNumbers.push_back(lineNumber);
+    }
+    return !lineNumbers.empty();
+}
+
+//The lines grep -n "\.exec(" would give for a file, for when there is no grep input
+std::vector<int> GrepParser::findCandidates(const std::string& contents) {
+    return findCandidates(contents.data(), contents.size());
+}
+
+std::vector<int> GrepParser::findCandidates(const char* text, size_t length) {
+    std::vector<int> lineNumbers;
+    const char* exec = ".exec(";
+    const char* end = text + length;
+    int lineNumber = 1;
+    const char* lineStart = text;
+    const char* match = text;
+    while ((match = std::search(match, end, exec, exec + 6)) != end) {
+        //Count the lines between the last match and this one
+        lineNumber += std::count(lineStart, match, '\n');
+        lineNumbers.push_back(lineNumber);
+        //Skip the rest of the line so each line is given once
+        lineStart = std::find(match, end, '\n');
+        if (lineStart == end)
+            break;
+        match = lineStart;
+    }
+    return lineNumbers;
+}
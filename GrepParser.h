@@ -32,9 +32,11 @@
 #ifndef GREPPARSER_H
 #define GREPPARSER_H
 
+#include <stdint.h>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <sstream>
 #include <vector>
 
 class GrepParser {
@@ -43,9 +45,25 @@ public:
     GrepParser(const std::string& filePath);
     ~GrepParser();
     void setInput(const std::string& filePath);
+    void setInputText(const std::string& text);
     std::map<std::string, std::vector<int>> parseInput();
+    bool parseNextFile(std::string& filePath, std::vector<int>& lineNumbers);
+    int getSkippedRunCount() const;
+    int getUncheckedFileCount() const;
+    static std::vector<int> findCandidates(const std::string& contents);
+    static std::vector<int> findCandidates(const char* text, size_t length);
 private:
+    bool parseNextRun(std::string& filePath, std::vector<int>& lineNumbers);
     std::istream* input;
+    std::string pendingLine;
+    //Hashes of the paths parseNextFile returned, open addressed with 0 for an empty slot.
+    //It grows to a fixed limit, so streamed input stays bounded however many files it lists
+    std::vector<uint64_t> pathHashes;
+    size_t pathCount;
+    int skippedRuns;
+    int uncheckedFiles;
+    bool rememberPath(const std::string& filePath);
+    static bool parseLine(const std::string& line, std::string& filePath, int& lineNumber);
 };
 
 #endif /* GREPPARSER_H */
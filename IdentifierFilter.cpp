@@ -0,0 +1,155 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   IdentifierFilter.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 19, 2026, 2:24 AM
+ */
+
+#include "IdentifierFilter.h"
+
+//With about 10 bits for each name and 4 probes, about 1 in 100 absent names gets through
+static const size_t bitsPerName = 10;
+static const int probeCount = 4;
+
+namespace {
+    //The regexes' \w, in the C locale
+    bool isWordChar(char c) {
+        return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_');
+    }
+    
+    //What can come before the space in a "Type name" declaration, findType's [\w<>\[\]]
+    bool isTypeChar(char c) {
+        return isWordChar(c) || (c == '<') || (c == '>') || (c == '[') || (c == ']');
+    }
+    
+    size_t wordEnd(const std::string& text, size_t start) {
+        size_t end = start;
+        while ((end < text.size()) && isWordChar(text[end]))
+            end++;
+        return end;
+    }
+    
+    //FNV-1a, split in two for the double hashing of the probes
+    uint64_t hashName(const char* name, size_t length) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= (unsigned char)name[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+IdentifierFilter::IdentifierFilter() {};
+
+//Every name findType's "[\w<>\[\]]+ name" could match in a function's text. The regex
+//has nothing after the name, so "String command" also matches "comm", and every
+//prefix of a declared word goes in.
+IdentifierFilter IdentifierFilter::forLocals(const std::string& text) {
+    std::vector<std::pair<size_t, size_t>> words;
+    size_t nameCount = 0;
+    for (size_t i = 1; i + 1 < text.size(); i++) {
+        if ((text[i] != ' ') || !isTypeChar(text[i-1]))
+            continue;
+        size_t end = wordEnd(text, i + 1);
+        if (end > i + 1) {
+            words.push_back(std::make_pair(i + 1, end - i - 1));
+            nameCount += end - i - 1;
+        }
+    }
+    IdentifierFilter filter;
+    filter.reserve(nameCount);
+    for (const std::pair<size_t, size_t>& word : words)
+        for (size_t length = 1; length <= word.second; length++)
+            filter.add(text.data() + word.first, length);
+    return filter;
+}
+
+//Every word findMemberType's "[\w<>\[\]]* name *(=|;)" could match in the member
+//region, a word after a space that is assigned or ends its statement
+IdentifierFilter IdentifierFilter::forMembers(const std::string& text) {
+    std::vector<std::pair<size_t, size_t>> words;
+    for (size_t i = 0; i + 1 < text.size(); i++) {
+        if (text[i] != ' ')
+            continue;
+        size_t end = wordEnd(text, i + 1);
+        size_t next = end;
+        while ((next < text.size()) && (text[next] == ' '))
+            next++;
+        if ((end > i + 1) && (next < text.size()) && ((text[next] == '=') || (text[next] == ';')))
+            words.push_back(std::make_pair(i + 1, end - i - 1));
+    }
+    IdentifierFilter filter;
+    filter.reserve(words.size());
+    for (const std::pair<size_t, size_t>& word : words)
+        filter.add(text.data() + word.first, word.second);
+    return filter;
+}
+
+//Length of the identifier a name starts with, 0 if it starts with something else
+size_t IdentifierFilter::leadingWordLength(const std::string& name) {
+    return wordEnd(name, 0);
+}
+
+bool IdentifierFilter::isWord(const std::string& name) {
+    return !name.empty() && (wordEnd(name, 0) == name.size());
+}
+
+//Size the bits for the names about to be added, a power of two so probes are masked
+void IdentifierFilter::reserve(size_t nameCount) {
+    size_t words = 1;
+    while (words * 64 < nameCount * bitsPerName)
+        words *= 2;
+    this->bits.assign(words, 0);
+}
+
+void IdentifierFilter::add(const char* name, size_t length) {
+    if (this->bits.empty())
+        this->reserve(1);
+    uint64_t hash = hashName(name, length);
+    uint64_t step = (hash >> 32) | 1;
+    uint64_t mask = this->bits.size() * 64 - 1;
+    for (int i = 0; i < probeCount; i++) {
+        uint64_t bit = (hash + i * step) & mask;
+        this->bits[bit / 64] |= (1ULL << (bit % 64));
+    }
+}
+
+//False only if the name was never added, an empty filter has nothing in it
+bool IdentifierFilter::mightContain(const char* name, size_t length) const {
+    if (this->bits.empty())
+        return false;
+    uint64_t hash = hashName(name, length);
+    uint64_t step = (hash >> 32) | 1;
+    uint64_t mask = this->bits.size() * 64 - 1;
+    for (int i = 0; i < probeCount; i++) {
+        uint64_t bit = (hash + i * step) & mask;
+        if (!(this->bits[bit / 64] & (1ULL << (bit % 64))))
+            return false;
+    }
+    return true;
+}
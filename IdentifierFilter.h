@@ -0,0 +1,57 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   IdentifierFilter.h
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 2:24 AM
+ */
+
+#ifndef IDENTIFIERFILTER_H
+#define IDENTIFIERFILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//A Bloom filter over the identifiers a piece of text could declare. It can tell that
+//a name certainly isn't declared there, so a lookup can give up without scanning the
+//text, or that it might be. It never rules out a name the scan would have found.
+class IdentifierFilter {
+public:
+    IdentifierFilter();
+    static IdentifierFilter forLocals(const std::string& text);
+    static IdentifierFilter forMembers(const std::string& text);
+    static size_t leadingWordLength(const std::string& name);
+    static bool isWord(const std::string& name);
+    void add(const char* name, size_t length);
+    bool mightContain(const char* name, size_t length) const;
+private:
+    void reserve(size_t nameCount);
+    std::vector<uint64_t> bits;
+};
+
+#endif /* IDENTIFIERFILTER_H */
@@ -0,0 +1,523 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   JavaExpression.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#include "JavaExpression.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+//Most candidates fit in one block, bigger requests get a block of their own
+static const size_t arenaBlockSize = 16384;
+
+std::string ExpressionNode::getText() const {
+    return std::string(this->text, this->length);
+}
+
+ExpressionArena::ExpressionArena() : blockUsed(0), currentBlock(0) {};
+
+ExpressionArena::~ExpressionArena() {
+    for (const std::pair<char*, size_t>& block : this->blocks)
+        delete[] block.first;
+}
+
+void* ExpressionArena::allocateBytes(size_t bytes) {
+    //Keep everything aligned for the pointers inside the nodes
+    const size_t alignment = sizeof(void*);
+    bytes = (bytes + alignment - 1) & ~(alignment - 1);
+    //Move on to the next block that still has room, reusing blocks after a reset
+    while ((this->currentBlock < this->blocks.size()) &&
+            (this->blockUsed + bytes > this->blocks[this->currentBlock].second)) {
+        this->currentBlock++;
+        this->blockUsed = 0;
+    }
+    if (this->currentBlock == this->blocks.size()) {
+        size_t blockSize = std::max(bytes, arenaBlockSize);
+        this->blocks.push_back(std::pair<char*, size_t>(new char[blockSize], blockSize));
+        this->blockUsed = 0;
+    }
+    void* memory = this->blocks[this->currentBlock].first + this->blockUsed;
+    this->blockUsed += bytes;
+    return memory;
+}
+
+ExpressionNode* ExpressionArena::allocate(ExpressionNode::Kind kind, const char* text, size_t length) {
+    ExpressionNode* node = static_cast<ExpressionNode*>(this->allocateBytes(sizeof(ExpressionNode)));
+    node->kind = kind;
+    node->text = text;
+    node->length = length;
+    node->target = NULL;
+    node->firstChild = NULL;
+    node->next = NULL;
+    return node;
+}
+
+//Copy source text into the arena so nodes can point into it
+const char* ExpressionArena::copy(const std::string& source) {
+    char* text = static_cast<char*>(this->allocateBytes(source.length() + 1));
+    memcpy(text, source.c_str(), source.length() + 1);
+    return text;
+}
+
+//Nodes handed out before are invalid after this, the blocks are kept for reuse
+void ExpressionArena::reset() {
+    this->currentBlock = 0;
+    this->blockUsed = 0;
+}
+
+ExpressionParser::ExpressionParser(ExpressionArena& arena) : arena(arena),
+        text(NULL), length(0), position(0), failed(false) {};
+
+//Parse a comma separated list of expressions, returning the first one
+//The rest follow through each node's next pointer
+ExpressionNode* ExpressionParser::parse(const std::string& expression) {
+    this->text = this->arena.copy(expression);
+    this->length = expression.length();
+    this->position = 0;
+    return this->parseList('\0');
+}
+
+ExpressionNode* ExpressionParser::parseList(char close) {
+    ExpressionNode* first = NULL;
+    ExpressionNode** link = &first;
+    this->skipSpace();
+    if ((this->position >= this->length) || (this->text[this->position] == close))
+        return NULL;
+    while (true) {
+        ExpressionNode* element = this->parseElement(close);
+        if (element != NULL) {
+            *link = element;
+            link = &element->next;
+        }
+        this->skipSpace();
+        if ((this->position < this->length) && (this->text[this->position] == ',')) {
+            this->position++;
+            continue;
+        }
+        break;
+    }
+    return first;
+}
+
+//One element of a list, anything the grammar doesn't cover is kept whole as Unknown
+ExpressionNode* ExpressionParser::parseElement(char close) {
+    this->skipSpace();
+    size_t start = this->position;
+    this->failed = false;
+    ExpressionNode* node = this->parseConcatenation();
+    this->skipSpace();
+    bool atDelimiter = (this->position >= this->length) || (this->text[this->position] == ',') ||
+            ((close != '\0') && (this->text[this->position] == close));
+    if (this->failed || (node == NULL) || !atDelimiter) {
+        this->position = start;
+        size_t end = this->skipToDelimiter(close);
+        this->position = end;
+        if (end == start)
+            return NULL;
+        node = this->finish(this->arena.allocate(ExpressionNode::Unknown, NULL, 0), start);
+    }
+    return node;
+}
+
+ExpressionNode* ExpressionParser::parseConcatenation() {
+    size_t start = this->position;
+    ExpressionNode* first = this->parseUnary();
+    if (first == NULL)
+        return NULL;
+    this->skipSpace();
+    //A lone operand isn't wrapped in a concatenation node
+    if ((this->position >= this->length) || (this->text[this->position] != '+') ||
+            ((this->position + 1 < this->length) && (strchr("+=", this->text[this->position+1]) != NULL)))
+        return first;
+    ExpressionNode* node = this->arena.allocate(ExpressionNode::Concatenation, NULL, 0);
+    node->firstChild = first;
+    ExpressionNode* last = first;
+    while ((this->position < this->length) && (this->text[this->position] == '+')) {
+        this->position++;
+        ExpressionNode* operand = this->parseUnary();
+        if (operand == NULL) {
+            this->failed = true;
+            return NULL;
+        }
+        last->next = operand;
+        last = operand;
+        this->skipSpace();
+    }
+    return this->finish(node, start);
+}
+
+ExpressionNode* ExpressionParser::parseUnary() {
+    this->skipSpace();
+    size_t start = this->position;
+    //(Type) operand, as long as it doesn't turn out to be (expression)
+    if ((this->position < this->length) && (this->text[this->position] == '(') && this->isCastAhead()) {
+        this->position++;
+        this->parseType();
+        this->skipSpace();
+        this->position++;
+        ExpressionNode* operand = this->parseUnary();
+        if (operand == NULL) {
+            this->failed = true;
+            return NULL;
+        }
+        ExpressionNode* node = this->arena.allocate(ExpressionNode::Cast, NULL, 0);
+        node->firstChild = operand;
+        return this->finish(node, start);
+    }
+    ExpressionNode* primary = this->parsePrimary();
+    if (primary == NULL)
+        return NULL;
+    return this->parsePostfix(primary);
+}
+
+//Member accesses, calls and array indexes following an expression
+ExpressionNode* ExpressionParser::parsePostfix(ExpressionNode* node) {
+    size_t start = node->text - this->text;
+    while (!this->failed) {
+        this->skipSpace();
+        if (this->position >= this->length)
+            break;
+        char c = this->text[this->position];
+        if ((c == '.') || ((c == '(') && (node->kind == ExpressionNode::Name) && (node->target == NULL))) {
+            size_t nameStart = this->position;
+            //A call without a receiver, like method(arguments)
+            bool hasReceiver = (c == '.');
+            if (hasReceiver) {
+                this->position++;
+                this->skipSpace();
+                if ((this->position >= this->length) || !this->isIdentifierStart(this->text[this->position])) {
+                    this->position = nameStart;
+                    break;
+                }
+                while ((this->position < this->length) && this->isIdentifierChar(this->text[this->position]))
+                    this->position++;
+                this->skipSpace();
+            }
+            if ((this->position < this->length) && (this->text[this->position] == '(')) {
+                this->position++;
+                ExpressionNode* arguments = this->parseList(')');
+                this->skipSpace();
+                if ((this->position >= this->length) || (this->text[this->position] != ')')) {
+                    this->failed = true;
+                    return NULL;
+                }
+                this->position++;
+                ExpressionNode* call = this->arena.allocate(ExpressionNode::Call, NULL, 0);
+                call->target = hasReceiver ? node : NULL;
+                call->firstChild = arguments;
+                node = this->finish(call, start);
+            }
+            //Dotted names stay one name, a.b.c is looked up as a whole
+            else if ((node->kind == ExpressionNode::Name) && (node->target == NULL)) {
+                node = this->finish(node, start);
+            }
+            else {
+                ExpressionNode* member = this->arena.allocate(ExpressionNode::Name, NULL, 0);
+                member->target = node;
+                node = this->finish(member, start);
+            }
+        }
+        else if (c == '[') {
+            //Array indexes are part of the name being looked up
+            size_t end = this->findClosing(this->position);
+            if (end >= this->length) {
+                this->failed = true;
+                return NULL;
+            }
+            this->position = end + 1;
+            node = this->finish(node, start);
+        }
+        else {
+            break;
+        }
+    }
+    return node;
+}
+
+ExpressionNode* ExpressionParser::parsePrimary() {
+    this->skipSpace();
+    if (this->position >= this->length) {
+        this->failed = true;
+        return NULL;
+    }
+    size_t start = this->position;
+    char c = this->text[this->position];
+    if ((c == '"') || (c == '\'') || isdigit(c) ||
+            ((c == '-') && (this->position + 1 < this->length) && isdigit(this->text[this->position+1])))
+        return this->parseLiteral();
+    //A parenthesized expression is just the expression inside
+    if (c == '(') {
+        this->position++;
+        ExpressionNode* inner = this->parseConcatenation();
+        this->skipSpace();
+        if ((inner == NULL) || (this->position >= this->length) || (this->text[this->position] != ')')) {
+            this->failed = true;
+            return NULL;
+        }
+        this->position++;
+        return inner;
+    }
+    //Array initializers, the closing brace is optional since callers often cut it off
+    if (c == '{') {
+        this->position++;
+        ExpressionNode* node = this->arena.allocate(ExpressionNode::ArrayInitializer, NULL, 0);
+        node->firstChild = this->parseList('}');
+        this->skipSpace();
+        if ((this->position < this->length) && (this->text[this->position] == '}'))
+            this->position++;
+        return this->finish(node, start);
+    }
+    if (this->isIdentifierStart(c)) {
+        if (this->matchWord("new"))
+            return this->parseNew(start);
+        if (this->matchWord("null") || this->matchWord("true") || this->matchWord("false"))
+            return this->finish(this->arena.allocate(ExpressionNode::Literal, NULL, 0), start);
+        while ((this->position < this->length) && this->isIdentifierChar(this->text[this->position]))
+            this->position++;
+        return this->finish(this->arena.allocate(ExpressionNode::Name, NULL, 0), start);
+    }
+    this->failed = true;
+    return NULL;
+}
+
+//new Type(arguments) or new Type[size] or new Type[] {elements}, "new" already read
+ExpressionNode* ExpressionParser::parseNew(size_t start) {
+    this->skipSpace();
+    if (!this->parseType()) {
+        this->failed = true;
+        return NULL;
+    }
+    this->skipSpace();
+    ExpressionNode* node = this->arena.allocate(ExpressionNode::New, NULL, 0);
+    if ((this->position < this->length) && (this->text[this->position] == '(')) {
+        this->position++;
+        this->parseList(')');
+        this->skipSpace();
+        if ((this->position >= this->length) || (this->text[this->position] != ')')) {
+            this->failed = true;
+            return NULL;
+        }
+        this->position++;
+        //Skip over the body of an anonymous class
+        this->skipSpace();
+        if ((this->position < this->length) && (this->text[this->position] == '{'))
+            this->position = std::min(this->findClosing(this->position) + 1, this->length);
+        return this->finish(node, start);
+    }
+    //Array dimensions, then an optional initializer which becomes the child
+    //Empty brackets were already read as part of the type
+    size_t typeEnd = this->position;
+    while ((typeEnd > start) && isspace(this->text[typeEnd-1]))
+        typeEnd--;
+    bool hasDimension = (this->text[typeEnd-1] == ']');
+    while ((this->position < this->length) && (this->text[this->position] == '[')) {
+        size_t end = this->findClosing(this->position);
+        if (end >= this->length) {
+            this->failed = true;
+            return NULL;
+        }
+        this->position = end + 1;
+        hasDimension = true;
+        this->skipSpace();
+    }
+    if (!hasDimension) {
+        this->failed = true;
+        return NULL;
+    }
+    if ((this->position < this->length) && (this->text[this->position] == '{'))
+        node->firstChild = this->parsePrimary();
+    return this->finish(node, start);
+}
+
+ExpressionNode* ExpressionParser::parseLiteral() {
+    size_t start = this->position;
+    char c = this->text[this->position];
+    if ((c == '"') || (c == '\'')) {
+        //Step over escapes until the closing quote
+        for (this->position++; (this->position < this->length) && (this->text[this->position] != c); this->position++)
+            if (this->text[this->position] == '\\')
+                this->position++;
+        if (this->position >= this->length) {
+            this->failed = true;
+            return NULL;
+        }
+        this->position++;
+    }
+    else {
+        this->position++;
+        while ((this->position < this->length) && (isalnum(this->text[this->position]) ||
+                (this->text[this->position] == '.') || (this->text[this->position] == '_')))
+            this->position++;
+    }
+    return this->finish(this->arena.allocate(ExpressionNode::Literal, NULL, 0), start);
+}
+
+//Type names like java.util.List<String>[], true if there was one
+bool ExpressionParser::parseType() {
+    if ((this->position >= this->length) || !this->isIdentifierStart(this->text[this->position]))
+        return false;
+    while (true) {
+        while ((this->position < this->length) && this->isIdentifierChar(this->text[this->position]))
+            this->position++;
+        this->skipSpace();
+        if ((this->position + 1 < this->length) && (this->text[this->position] == '.') &&
+                this->isIdentifierStart(this->text[this->position+1])) {
+            this->position++;
+            continue;
+        }
+        break;
+    }
+    //Generic arguments, which can nest
+    if ((this->position < this->length) && (this->text[this->position] == '<')) {
+        int depth = 0;
+        for (; this->position < this->length; this->position++) {
+            if (this->text[this->position] == '<')
+                depth++;
+            else if ((this->text[this->position] == '>') && (--depth == 0))
+                break;
+            else if (!isalnum(this->text[this->position]) && !strchr(" ,.?_[]", this->text[this->position]))
+                return false;
+        }
+        if (this->position >= this->length)
+            return false;
+        this->position++;
+    }
+    //Empty brackets of an array type, sized ones are left for new to read
+    while (true) {
+        this->skipSpace();
+        if ((this->position + 1 < this->length) && (this->text[this->position] == '[')) {
+            size_t close = this->position + 1;
+            while ((close < this->length) && (this->text[close] == ' '))
+                close++;
+            if ((close < this->length) && (this->text[close] == ']')) {
+                this->position = close + 1;
+                continue;
+            }
+        }
+        break;
+    }
+    return true;
+}
+
+//(Type) followed by the start of an operand is a cast, (a) + b is not
+bool ExpressionParser::isCastAhead() {
+    size_t saved = this->position;
+    this->position++;
+    this->skipSpace();
+    bool isCast = this->parseType();
+    this->skipSpace();
+    if (isCast && (this->position < this->length) && (this->text[this->position] == ')')) {
+        this->position++;
+        this->skipSpace();
+        char c = (this->position < this->length) ? this->text[this->position] : '\0';
+        isCast = this->isIdentifierStart(c) || isdigit(c) || (c == '"') || (c == '\'') || (c == '(');
+    }
+    else {
+        isCast = false;
+    }
+    this->position = saved;
+    return isCast;
+}
+
+//Find the next ',' or close character that isn't nested or inside a literal
+size_t ExpressionParser::skipToDelimiter(char close) {
+    int depth = 0;
+    size_t i = this->position;
+    for (; i < this->length; i++) {
+        char c = this->text[i];
+        if ((depth == 0) && ((c == ',') || ((close != '\0') && (c == close))))
+            break;
+        if ((c == '"') || (c == '\'')) {
+            for (i++; (i < this->length) && (this->text[i] != c); i++)
+                if (this->text[i] == '\\')
+                    i++;
+        }
+        else if ((c == '(') || (c == '[') || (c == '{'))
+            depth++;
+        else if (((c == ')') || (c == ']') || (c == '}')) && (--depth < 0))
+            break;
+    }
+    return std::min(i, this->length);
+}
+
+//Find the bracket closing the one at open, or the end of the text if it never closes
+size_t ExpressionParser::findClosing(size_t open) {
+    int depth = 0;
+    size_t i = open;
+    for (; i < this->length; i++) {
+        char c = this->text[i];
+        if ((c == '"') || (c == '\'')) {
+            for (i++; (i < this->length) && (this->text[i] != c); i++)
+                if (this->text[i] == '\\')
+                    i++;
+        }
+        else if ((c == '(') || (c == '[') || (c == '{'))
+            depth++;
+        else if (((c == ')') || (c == ']') || (c == '}')) && (--depth == 0))
+            return i;
+    }
+    return this->length;
+}
+
+void ExpressionParser::skipSpace() {
+    while ((this->position < this->length) && isspace(this->text[this->position]))
+        this->position++;
+}
+
+bool ExpressionParser::isIdentifierStart(char c) {
+    return isalpha(c) || (c == '_') || (c == '$');
+}
+
+bool ExpressionParser::isIdentifierChar(char c) {
+    return isalnum(c) || (c == '_') || (c == '$');
+}
+
+//Read a keyword if it is next, and not just the start of a longer identifier
+bool ExpressionParser::matchWord(const char* word) {
+    size_t wordLength = strlen(word);
+    if ((this->position + wordLength > this->length) ||
+            (strncmp(this->text + this->position, word, wordLength) != 0))
+        return false;
+    if ((this->position + wordLength < this->length) &&
+            this->isIdentifierChar(this->text[this->position + wordLength]))
+        return false;
+    this->position += wordLength;
+    return true;
+}
+
+//Set a node's text to everything from start up to the current position
+ExpressionNode* ExpressionParser::finish(ExpressionNode* node, size_t start) {
+    size_t end = this->position;
+    while ((end > start) && isspace(this->text[end-1]))
+        end--;
+    node->text = this->text + start;
+    node->length = end - start;
+    return node;
+}
@@ -0,0 +1,102 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   JavaExpression.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef JAVAEXPRESSION_H
+#define JAVAEXPRESSION_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+//A node of the small Java expression grammar found at exec call sites
+//Children are kept as a linked list so building a node never copies a vector
+struct ExpressionNode {
+    enum Kind { Literal, Name, Concatenation, Call, Cast, ArrayInitializer, New, Unknown };
+    Kind kind;
+    const char* text;
+    size_t length;
+    //Receiver of a call or base of a member access, NULL if there is none
+    ExpressionNode* target;
+    ExpressionNode* firstChild;
+    ExpressionNode* next;
+    std::string getText() const;
+};
+
+//Hands out nodes from large blocks, everything is freed at once by reset()
+class ExpressionArena {
+public:
+    ExpressionArena();
+    ~ExpressionArena();
+    ExpressionNode* allocate(ExpressionNode::Kind kind, const char* text, size_t length);
+    const char* copy(const std::string& source);
+    void reset();
+private:
+    ExpressionArena(const ExpressionArena&);
+    ExpressionArena& operator=(const ExpressionArena&);
+    void* allocateBytes(size_t bytes);
+    std::vector<std::pair<char*, size_t>> blocks;
+    size_t blockUsed;
+    size_t currentBlock;
+};
+
+//Recursive descent parser for literals, concatenation, calls, casts,
+//array initializers and new, anything else becomes an Unknown node
+class ExpressionParser {
+public:
+    ExpressionParser(ExpressionArena& arena);
+    ExpressionNode* parse(const std::string& expression);
+private:
+    ExpressionArena& arena;
+    const char* text;
+    size_t length;
+    size_t position;
+    bool failed;
+    ExpressionNode* parseList(char close);
+    ExpressionNode* parseElement(char close);
+    ExpressionNode* parseConcatenation();
+    ExpressionNode* parseUnary();
+    ExpressionNode* parsePostfix(ExpressionNode* node);
+    ExpressionNode* parsePrimary();
+    ExpressionNode* parseNew(size_t start);
+    ExpressionNode* parseLiteral();
+    bool parseType();
+    bool isCastAhead();
+    size_t skipToDelimiter(char close);
+    size_t findClosing(size_t open);
+    void skipSpace();
+    bool isIdentifierStart(char c);
+    bool isIdentifierChar(char c);
+    bool matchWord(const char* word);
+    ExpressionNode* finish(ExpressionNode* node, size_t start);
+};
+
+#endif /* JAVAEXPRESSION_H */
@@ -30,87 +30,240 @@
  */
 
 #include "JavaParser.h"
+#include "CandidateProfiler.h"
 #include "Utility.h"
 #include <algorithm>
+#include <cctype>
 
 #include <iostream>
 
-JavaParser::JavaParser(const std::string& filePath) : javaReader(filePath) {};
+//Java identifier characters, only ASCII ones count the same as \w in the patterns
+static bool isWordChar(char c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+//The parameter names of a method, from its header up to the "{"
+//The name is the last word of each parameter, "String... args" included
+static std::vector<std::string> readParameters(const std::string& functionHeader, const std::string& functionName) {
+    std::vector<std::string> parameters;
+    //The parameter list is between the parentheses after the name
+    size_t listStart = functionHeader.find(functionName + "(");
+    size_t listEnd = functionHeader.rfind(")");
+    if ((listStart == std::string::npos) || (listEnd == std::string::npos))
+        return parameters;
+    listStart += functionName.length() + 1;
+    std::string parameterList = Util::trim(functionHeader.substr(listStart, listEnd - listStart));
+    if (parameterList.empty())
+        return parameters;
+    for (const std::string& parameter : Util::splitNotAtDepth(parameterList, ",")) {
+        std::string trimmed = Util::trim(parameter);
+        while (Util::endsWith(trimmed, "[]"))
+            trimmed = Util::trim(trimmed.substr(0, trimmed.length() - 2));
+        size_t nameStart = trimmed.find_last_of(" \t\n.]") + 1;
+        parameters.push_back(trimmed.substr(nameStart));
+    }
+    return parameters;
+}
+
+//Find the ';' ending the statement starting at start, skipping over strings
+static size_t findStatementEnd(const std::string& text, size_t start) {
+    char quote = 0;
+    for (size_t i = start; i < text.length(); i++) {
+        //Inside a string or char literal only the closing quote matters
+        if (quote) {
+            if (text[i] == '\\')
+                i++;
+            else if (text[i] == quote)
+                quote = 0;
+        }
+        else if ((text[i] == '"') || (text[i] == '\''))
+            quote = text[i];
+        else if (text[i] == ';')
+            return i;
+    }
+    return std::string::npos;
+}
+
+JavaFileIndex::JavaFileIndex(const std::string& filePath) : javaReader(filePath),
+        filterLookups(0), filterRejections(0) {};
+
+JavaFileIndex::JavaFileIndex(const std::string& filePath, std::string& contents) :
+        javaReader(filePath, contents), filterLookups(0), filterRejections(0) {};
+
+JavaFileIndex::JavaFileIndex(const std::string& filePath, const ProjectSnapshot::File& file) :
+        javaReader(filePath, file), filterLookups(0), filterRejections(0) {};
+
+JavaParser::JavaParser(const std::string& filePath) :
+        fileIndex(new JavaFileIndex(filePath)), javaReader(fileIndex->javaReader),
+        summaries(fileIndex->summaries), membersRead(false), classVariablesRead(false), candidateBudget(NULL), fileBudget(NULL),
+        provisionalChanges(0) {};
+
+JavaParser::JavaParser(const std::string& filePath, std::string& contents) :
+        fileIndex(new JavaFileIndex(filePath, contents)), javaReader(fileIndex->javaReader),
+        summaries(fileIndex->summaries), membersRead(false), classVariablesRead(false), candidateBudget(NULL), fileBudget(NULL),
+        provisionalChanges(0) {};
+
+JavaParser::JavaParser(const std::shared_ptr<JavaFileIndex>& fileIndex) :
+        fileIndex(fileIndex), javaReader(fileIndex->javaReader),
+        summaries(fileIndex->summaries), membersRead(false), classVariablesRead(false), candidateBudget(NULL), fileBudget(NULL),
+        provisionalChanges(0) {};
+
+std::shared_ptr<JavaFileIndex> JavaParser::getFileIndex() {
+    return this->fileIndex;
+}
 
 std::string JavaParser::getFunctionName(int lineNumber) {
     return this->javaReader.readFunctionName(lineNumber);
 }
 
+//Read a function's body in ahead of classifying all of its candidates together
+//Charge the queries of this parser to a candidate's budget and its file's, either may be NULL
+void JavaParser::setBudgets(WorkBudget* candidateBudget, WorkBudget* fileBudget) {
+    this->candidateBudget = candidateBudget;
+    this->fileBudget = fileBudget;
+}
+
+bool JavaParser::isOverBudget() const {
+    return ((this->candidateBudget != NULL) && this->candidateBudget->isExhausted()) ||
+            ((this->fileBudget != NULL) && this->fileBudget->isExhausted());
+}
+
+void JavaParser::prepareFunction(const std::string& functionName) {
+    this->readFunction(functionName);
+}
+
 std::string JavaParser::getFullStatement(int lineNumber) {
-    //Read extra lines to account for the line wrapping
-    std::string extraLines = this->javaReader.readLines(
-        std::pair<int,int>(lineNumber, lineNumber + 10));
-    int quoteDepth = 0;
-    int statementEnd = 0;
-    //Need to account for ';' being inside a string
-    while ((extraLines[statementEnd] != ';') || (quoteDepth > 0)) {
-        statementEnd++;
-        if (extraLines[statementEnd] == '"')
-            quoteDepth = (quoteDepth + 1) % 2;
+    CandidateProfiler::Scope profileScope("getFullStatement");
+    //Find the statement in the file buffer, however many lines it wraps over
+    JavaStatement source = this->javaReader.readStatement(lineNumber);
+    const char* text = source.text;
+    size_t length = source.length;
+    //Put the lines back together with single spaces, leaving comments out
+    std::string statement;
+    statement.reserve(length);
+    size_t i = 0;
+    //A line that starts with // is a commented out statement, so keep the // as written
+    while ((i < length) && ((text[i] == ' ') || (text[i] == '\t')))
+        i++;
+    if ((i + 1 < length) && (text[i] == '/') && (text[i+1] == '/')) {
+        statement += "//";
+        i += 2;
+    }
+    bool lineStart = false;
+    for (; i < length; i++) {
+        char c = text[i];
+        //Indentation at the start of every line is dropped
+        if (lineStart && ((c == ' ') || (c == '\t')))
+            continue;
+        lineStart = false;
+        if (c == '\n') {
+            //Trailing whitespace before a line break goes too
+            statement.erase(statement.find_last_not_of(" \t\r") + 1);
+            statement += ' ';
+            lineStart = true;
+        }
+        else if ((c == '"') || (c == '\'')) {
+            //Copy literals whole so quotes and slashes inside them are left alone
+            size_t literalEnd = i + 1;
+            while ((literalEnd < length) && (text[literalEnd] != c) && (text[literalEnd] != '\n'))
+                literalEnd += (text[literalEnd] == '\\') ? 2 : 1;
+            literalEnd = std::min(literalEnd, length - 1);
+            statement.append(text + i, literalEnd - i + 1);
+            i = literalEnd;
+        }
+        else if ((c == '/') && (i + 1 < length) && (text[i+1] == '/')) {
+            //Comments inside the statement are skipped up to the end of their line
+            while ((i + 1 < length) && (text[i+1] != '\n'))
+                i++;
+        }
+        else if ((c == '/') && (i + 1 < length) && (text[i+1] == '*')) {
+            size_t commentEnd = i + 2;
+            while ((commentEnd + 1 < length) && !((text[commentEnd] == '*') && (text[commentEnd+1] == '/')))
+                commentEnd++;
+            //Block comments can wrap lines, so count their newlines as a break
+            if (std::find(text + i, text + commentEnd, '\n') != text + commentEnd) {
+                statement.erase(statement.find_last_not_of(" \t\r") + 1);
+                statement += ' ';
+                lineStart = true;
+            }
+            i = commentEnd + 1;
+        }
+        else {
+            statement += c;
+        }
     }
-    //Take the substring and replace newline characters with spaces
-    std::string statement = extraLines.substr(0, statementEnd);
-    std::replace(statement.begin(), statement.end(), '\n', ' ');
     return statement;
 }
   
-std::string JavaParser::findType(const std::string& variableName, const std::string& functionName) {
+//Type names are only added to the symbol table when they are reported, the ones found
+//along the way are looked up, since the table is shared and never shrinks
+Symbol JavaParser::typeSymbol(const std::string& typeName, bool reported) const {
+    if (reported)
+        return Symbols::intern(typeName);
+    Symbol symbol = Symbols::find(typeName);
+    return (symbol == Symbols::Empty) ? Symbols::Unlisted : symbol;
+}
+
+Symbol JavaParser::findType(const std::string& variableName, const std::string& functionName, bool reported) {
+    CandidateProfiler::Scope profileScope("findType");
+    //Out of budget, the candidate is unresolved whatever we answer
+    if (!this->spend())
+        return Symbols::Empty;
     //If standalone argument is surrounded by " " it's a string
     if (Util::startsWith(variableName,"\"") && Util::endsWith(variableName,"\""))
-        return std::string("String literal");
+        return Symbols::StringLiteral;
     //If it only has numerical digits it is an integer
     if (variableName.find_first_not_of("0123456789") == std::string::npos)
-        return std::string("Integer literal");
+        return Symbols::IntegerLiteral;
     //If it has a decimal point followed by a decimal it's a double
     if (Util::regexFind(variableName, "[0-9]*\\.[0-9]+") != std::string::npos)
-        return std::string("Double literal");
+        return Symbols::DoubleLiteral;
     //'this' has the same type as the parent class
     if (!variableName.compare("this"))
-        return javaReader.getClassName();
+        return this->typeSymbol(javaReader.getClassName(), reported);
     //Null is likely string type, but making it null type was simpler
     if (!variableName.compare("null"))
-        return std::string("null");
+        return Symbols::Null;
     if (Util::regexFind(variableName, "\\(.*\\) *null") != std::string::npos)
-        return std::string("null");
+        return Symbols::Null;
     //There should be more of these, but most inputs are just String and String[]
     if (!variableName.compare("String") || !variableName.compare("Integer") || !variableName.compare("System"))
-        return std::string("Static Class");
+        return Symbols::StaticClass;
     //If there is a new keyword, the argument will tell us its type
     if (Util::startsWith(variableName, "new")) {
         //Arrays can have specified size, so need to avoid capturing that
         if (Util::startsWith(variableName, "new String["))
-            return std::string("String[]");
+            return Symbols::StringArray;
         int typeStart = 4;
         int typeEnd = Util::regexFind(variableName, "( |\\{|\\()", 4);
-        return variableName.substr(typeStart, typeEnd - typeStart);
+        return this->typeSymbol(variableName.substr(typeStart, typeEnd - typeStart), reported);
     }
     //If there is a cast, the argument will also tell us its type
     //Otherwise we have a regular function
     if (Util::regexFind(variableName, "\\(.*\\)") != std::string::npos)
-        return std::string("function");
+        return Symbols::Function;
     //If there is a plus sign at the current depth, then we have an expression
     if (variableName.find("+") != std::string::npos)
         if (!Util::getDepth(variableName, variableName.find("+")))
-            return std::string("expression");
+            return Symbols::Expression;
     //Get the function body so we can look for variable definitions
-    std::string functionBody = this->javaReader.readFunction(functionName);
+    const std::string& functionBody = this->readFunction(functionName);
+    //A name the function never declares can't be found by the scans below
+    if (!this->mightDeclare(this->getFunctionFilter(functionName), variableName,
+            IdentifierFilter::leadingWordLength(variableName)))
+        return Symbols::Empty;
     //One file has an ugly space, so I've corrected it like this
     if (functionBody.find("String [] " + variableName) != std::string::npos)
-        return std::string("String[]");
+        return Symbols::StringArray;
     //Need to declare internal variables outside for the do while loop
     int lineNumber = 0;
     int firstOccurance = 0;
     do {
         //The "[\w<>\[\]] variableName" regex should represent all type definitions
         firstOccurance = Util::regexFind(functionBody, "[\\w<>\\[\\]]+ " + Util::escapeRegex(variableName), firstOccurance + 1);
-        //If the variable is defined outside the function just return empty string
+        //If the variable is defined outside the function just return empty
         if (firstOccurance == std::string::npos) {
-            return std::string();
+            return Symbols::Empty;
         }
         //The associated line number is the start of function plus number of newlines
         lineNumber = this->javaReader.getFunctionBounds(functionName).first +
@@ -118,56 +271,88 @@ std::string JavaParser::findType(const std::string& variableName, const std::str
     //If line is commented, or declaration is inside (){}"", keep looking
     } while (this->isCommented(lineNumber));
     //Return the substring from the regexFind to the next space
-    return functionBody.substr(firstOccurance,
-            functionBody.find(" ", firstOccurance) - firstOccurance);
-}
-
-std::string JavaParser::findMemberType(const std::string& variableName) {
-    //Get the class name so we can find where the constructor is
-    //Hoping good style is used, member functions should be before it
-    std::string className = this->javaReader.getClassName();
-    int endOfMembers = this->javaReader.getFunctionBounds(className).first - 1;
-    //If the file doesn't have a constructor than this is the failure value
-    if (endOfMembers == -2)
-        endOfMembers = 1000;
-    //Extract all of the text between the start of the file and the constructor
-    std::string textRegion = this->javaReader.readLines(std::pair<int,int>(1,endOfMembers));
+    return this->typeSymbol(functionBody.substr(firstOccurance,
+            functionBody.find(" ", firstOccurance) - firstOccurance), reported);
+}
+
+//The type of a node of the candidate's tree, string literals are told by their node
+//and anything else by its text, which is only copied out for the lookups that need it
+Symbol JavaParser::findType(const ExpressionNode* node, const std::string& functionName, bool reported) {
+    if ((node->kind == ExpressionNode::Literal) && (node->length >= 2) &&
+            (node->text[0] == '"') && (node->text[node->length - 1] == '"')) {
+        CandidateProfiler::Scope profileScope("findType");
+        if (!this->spend())
+            return Symbols::Empty;
+        return Symbols::StringLiteral;
+    }
+    return this->findType(node->getText(), functionName, reported);
+}
+
+Symbol JavaParser::findMemberType(const std::string& variableName, bool reported) {
+    CandidateProfiler::Scope profileScope("findMemberType");
+    const std::string& textRegion = this->readMembers();
+    //A plain name no member is declared as can't be found by the scan below
+    if (IdentifierFilter::isWord(variableName) &&
+            !this->mightDeclare(this->memberFilter, variableName, variableName.size()))
+        return Symbols::Empty;
     //Look for the start of a method declaration (same as findType but "(=|;)")
     int typeStart = Util::regexFind(textRegion, "[\\w<>\\[\\]]* " + Util::escapeRegex(variableName) + " *(=|;)");
-    //If no matching declaration was found return empty string
+    //If no matching declaration was found return empty
     if (typeStart == std::string::npos)
-        return std::string();
+        return Symbols::Empty;
     //Otherwise find the space after the regex and return the type
     int typeEnd = textRegion.find(" ", typeStart);
-    std::string type = textRegion.substr(typeStart, typeEnd - typeStart);
-    return type;
+    return this->typeSymbol(textRegion.substr(typeStart, typeEnd - typeStart), reported);
 }
 
-bool JavaParser::isInput(const std::string& variableName, const std::string& functionName) {
+bool JavaParser::isInput(const ExpressionNode* node, const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("isInput");
+    if (!this->spend())
+        return false;
     //Find the function header, being all of the text before "{"
-    std::string functionBody = this->javaReader.readFunction(functionName);
+    const std::string& functionBody = this->readFunction(functionName);
     std::string functionHeader = functionBody.substr(0, functionBody.find("{"));
     //Find the type of the variable to keep regexing separate
-    std::string variableType = this->findType(variableName, functionName);
+    std::string variableName = node->getText();
+    Symbol variableType = this->findType(node, functionName);
     //One of the weird poorly formatted files coming back to haunt me
-    if (variableType == "String[]")
+    bool inHeader = false;
+    if (variableType == Symbols::StringArray)
         if (functionHeader.find("String [] " + variableName) != std::string::npos)
-            return true;
-    //Return whether or not the definition was in the header
-    return (functionHeader.find(variableType + " " + variableName) != std::string::npos);
+            inHeader = true;
+    //Check whether or not the definition was in the header
+    if (functionHeader.find(Symbols::getName(variableType) + " " + variableName) != std::string::npos)
+        inHeader = true;
+    //Locals set from a method of this file can still carry one of our parameters
+    if (!inHeader)
+        return this->isForwardedInput(variableName, functionName);
+    //Parameters of private helpers are only input if a caller passes input along
+    MethodSummary::Source source = this->getCallerSource(variableName, functionName);
+    if (source != MethodSummary::Unresolved)
+        return (source == MethodSummary::FromInput);
+    return true;
 }
 
-bool JavaParser::isHardcoded(const std::string& variableName, const std::string& functionName) {
+//Walks the candidate's tree, only the values read out of the function's text are parsed
+bool JavaParser::isHardcoded(const ExpressionNode* node, const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("isHardcoded");
+    if (!this->spend())
+        return false;
+    std::string variableName = node->getText();
+    //Parameters of private helpers are hardcoded if every caller hardcodes them
+    MethodSummary::Source source = this->getCallerSource(variableName, functionName);
+    if (source != MethodSummary::Unresolved)
+        return (source == MethodSummary::FromHardcoded);
     //Check whether the variable is input to the function, if so it's not hardcoded
-    if (this->isInput(variableName, functionName))
+    if (this->isInput(node, functionName))
         return false;
     //Get the function text and also the type of the variable
-    std::string functionBody = this->javaReader.readFunction(functionName);
-    std::string variableType = this->findType(variableName, functionName);
-    if (variableType.empty())
+    const std::string& functionBody = this->readFunction(functionName);
+    Symbol variableType = this->findType(node, functionName);
+    if (variableType == Symbols::Empty)
         variableType = this->findMemberType(variableName);
     //If the type is string, check if it was given hard coded " "
-    if (!variableType.compare("String")) {
+    if (variableType == Symbols::String) {
         //Get location so we have somewhere to start
         int location = Util::regexFind(functionBody, Util::escapeRegex(variableName) + " *= *.*;");
         if (location != std::string::npos) {
@@ -183,33 +368,31 @@ bool JavaParser::isHardcoded(const std::string& variableName, const std::string&
                 start = temp.find_first_not_of(" ");
                 end = temp.find_last_of(")");
                 temp = temp.substr(start, end - start);
-                return this->isHardcoded(Util::trim(temp), functionName);
+                return this->isHardcoded(this->parseValue(temp), functionName);
             }          
             //Otherwise check the input
             int decStart = functionBody.find("=", location) + 1;
             int decEnd = functionBody.find(";", location);
             std::string rightSide = functionBody.substr(decStart, decEnd - decStart);
-            return this->isHardcoded(Util::trim(rightSide), functionName);
+            return this->isHardcoded(this->parseValue(rightSide), functionName);
         }
         //If the string was created outside of the function, check class variables
-        int classVarEnd = this->javaReader.getFunctionBounds(this->javaReader.getClassName()).first - 1;
-        std::string classVars = this->javaReader.readLines(std::pair<int,int>(1, classVarEnd));
+        const std::string& classVars = this->readClassVariables();
         return (Util::regexFind(classVars, Util::escapeRegex(variableName) + " *= *\".*\"") != std::string::npos);
     }
     //If the type is int, check if it was defined as a given digit
-    else if (!variableType.compare("int")) {
+    else if (variableType == Symbols::Int) {
         if (Util::regexFind(functionBody, Util::escapeRegex(variableName) + " *= *\\d+") != std::string::npos)
             true;
-        int classVarEnd = this->javaReader.getFunctionBounds(this->javaReader.getClassName()).first - 1;
-        std::string classVars = this->javaReader.readLines(std::pair<int,int>(1, classVarEnd));
+        const std::string& classVars = this->readClassVariables();
         return (Util::regexFind(classVars, Util::escapeRegex(variableName) + " *= *\\d+") != std::string::npos);
     }
     //"Null" is an imaginary type for classing these, all are hardcoded
-    else if (!variableType.compare("null")) {
+    else if (variableType == Symbols::Null) {
         return true;
     }
     //For string arrays, check their definition for any non-hardcoded variables
-    else if (!variableType.compare("String[]")) {
+    else if (variableType == Symbols::StringArray) {
         std::string stringArr = this->getStringArr(variableName, functionName);
         //If they were not hard coded with { }, check function if it exists
         if (stringArr.empty()) {
@@ -219,40 +402,45 @@ bool JavaParser::isHardcoded(const std::string& variableName, const std::string&
                 int decStart = functionBody.find("=", location) + 1;
                 int decEnd = functionBody.find(";", location);
                 std::string rightSide = functionBody.substr(decStart, decEnd - decStart);
-                return this->isHardcoded(Util::trim(rightSide), functionName);
+                return this->isHardcoded(this->parseValue(rightSide), functionName);
             }
         }
         //If the array is not empty, recursively split it, and check if any part is not hardcoded
         else {
-            for (const std::string& s : this->parseRecursively(this->parseStringArr(stringArr), functionName))
-                if (!this->isHardcoded(s, functionName))
+            for (const ExpressionNode* leaf : this->parseRecursively(std::vector<std::string>(1, stringArr), functionName))
+                if (!this->isHardcoded(leaf, functionName))
                     return false;
             return true;
         }
     }
     //For functions we need to worry about whether all of the inputs are hardcoded
-    else if (!variableType.compare("function")) {
-        std::vector<std::string> parts = this->parseExpression(variableName);
-        std::vector<std::string> functionParts = this->parseFunction(variableName);
-        for (const std::string& s : this->parseRecursively(functionParts, functionName))
-            if (!this->isHardcoded(s, functionName))
+    else if (variableType == Symbols::Function) {
+        //Methods of this file are hardcoded if what they return is, given the arguments
+        std::string callee;
+        std::vector<std::string> arguments;
+        if (this->isLocalCall(variableName, callee, arguments)) {
+            std::set<int> returnParameters;
+            if (!this->resolveReturns(callee, returnParameters))
                 return false;
-        return true;
+            for (int index : returnParameters)
+                for (const ExpressionNode* leaf : this->parseRecursively(
+                        std::vector<std::string>(1, arguments[index]), functionName))
+                    if (!this->isHardcoded(leaf, functionName))
+                        return false;
+            return true;
+        }
+        return this->areLeavesHardcoded(node, functionName);
     }
-    //For expressions we do the same thing as functions but start differently
-    else if (!variableType.compare("expression")) {
-        std::vector<std::string> parts = this->parseExpression(variableName);
-        for (const std::string& s : this->parseRecursively(parts, functionName))
-            if (!this->isHardcoded(s, functionName))
-                return false;
-        return true;
+    //Expressions are walked the same way, down to the operands of the +
+    else if (variableType == Symbols::Expression) {
+        return this->areLeavesHardcoded(node, functionName);
     }
     //If the variable is a literal, return true
-    else if (variableType.find(" literal") != std::string::npos) {
+    else if (Symbols::isLiteral(variableType)) {
         return true;
     }
     //Source code is hardcoded, not the best trick calling this a variable
-    else if (!variableType.compare("Static Class"))
+    else if (variableType == Symbols::StaticClass)
         return true;
     //Result may or may not be hard coded, need more tests
     else {
@@ -262,35 +450,27 @@ bool JavaParser::isHardcoded(const std::string& variableName, const std::string&
     return true;
 }
 
+//Whether every leaf under the node is hardcoded, a node that is its own only leaf can't
+//be split any further, so it isn't
+bool JavaParser::areLeavesHardcoded(const ExpressionNode* node, const std::string& functionName) {
+    std::vector<const ExpressionNode*> leaves;
+    this->collectLeaves(node, functionName, leaves);
+    if ((leaves.size() == 1) && (leaves[0] == node))
+        return false;
+    for (const ExpressionNode* leaf : leaves)
+        if (!this->isHardcoded(leaf, functionName))
+            return false;
+    return true;
+}
+
 //TODO: slowest link, move to JavaReader main
 bool JavaParser::isCommented(int lineNumber) {
-    //Get the start of the function so we can read it in
-    int functionStart = this->javaReader.getFunctionBounds(lineNumber).first;
-    //Read in the function up to the specified line
-    std::string functionBody = this->javaReader.readLines(
-            std::pair<int,int>(functionStart, lineNumber));
-    //Reverse find up to the following so we can check for comments
-    int bodyEnd = functionBody.size() - 2;
-    int slashLoc = functionBody.rfind("//", bodyEnd);
-    int endlLoc = functionBody.rfind("\n", bodyEnd);
-    int openLoc = functionBody.rfind("/*", bodyEnd);
-    int closeLoc = functionBody.rfind("*/", bodyEnd);
-    //If there is a // on this line, return true
-    if (slashLoc != std::string::npos)
-        if (slashLoc > endlLoc)
-            return true;
-    //If there is no open return false
-    if (openLoc == std::string::npos)
-        return false;
-    //If there is an open and no close return true
-    else if (closeLoc == std::string::npos)
-        return true;
-    //Otherwise return whether the nearest one is an open or a close
-    else
-        return (openLoc > closeLoc);
+    CandidateProfiler::Scope profileScope("isCommented");
+    return this->javaReader.isCommented(lineNumber);
 }
 
 std::string JavaParser::getExpression(const std::string& functionName, int lineNumber) {
+    CandidateProfiler::Scope profileScope("getExpression");
     //Get the full line at the line number
     std::string statement = this->getFullStatement(lineNumber);
     //return empty string if the function is not there
@@ -310,10 +490,13 @@ std::string JavaParser::getExpression(const std::string& functionName, int lineN
         //If we have exited the function, return the substring
         if (parenDepth == 0)
             return statement.substr(expressionStart, i - expressionStart);
-    }   
+    }
+    //The parentheses never closed, so there is no complete expression
+    return std::string();
 }
 
 std::string JavaParser::getStringArr(const std::string& stringArrName, const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("getStringArr");
     //Try and find { } of an array declaration
     int arrStart = stringArrName.find_first_of("{");
     int arrEnd = stringArrName.find_last_of("}") + 1;
@@ -322,7 +505,7 @@ std::string JavaParser::getStringArr(const std::string& stringArrName, const std
         return stringArrName.substr(arrStart, arrEnd - arrStart);
     //Otherwise we need to look for the declaration
     int location = -1;
-    std::string functionBody = this->javaReader.readFunction(functionName);
+    const std::string& functionBody = this->readFunction(functionName);
     //If there is a declaration inside the function, return the { } part
     if ((location = Util::regexFind(functionBody, stringArrName + " *=[^;]*\\{.*\\}")) != std::string::npos) {
         int arrayStart = functionBody.find("{", location);
@@ -332,8 +515,7 @@ std::string JavaParser::getStringArr(const std::string& stringArrName, const std
         return array;
     }
     //If there is a declaration in the class variables, return the { } part
-    int classVarEnd = this->javaReader.getFunctionBounds(this->javaReader.getClassName()).first - 1;
-    std::string classVars = this->javaReader.readLines(std::pair<int,int>(1, classVarEnd));
+    const std::string& classVars = this->readClassVariables();
     if ((location = Util::regexFind(classVars, stringArrName + " *=[^;]*\\{.*\\}")) != std::string::npos) {
         int arrayStart = classVars.find("{", location);
         int arrayEnd = classVars.find("}", arrayStart);
@@ -345,126 +527,561 @@ std::string JavaParser::getStringArr(const std::string& stringArrName, const std
     return std::string();
 }
 
-std::vector<std::string> JavaParser::parseExpression(const std::string& functionName, int lineNumber) {
-    //Get the parsed expression at the line number
+//The leaves stay good until the next candidate's call, which resets the arena
+std::vector<const ExpressionNode*> JavaParser::parseRecursively(const std::string& functionName, int lineNumber) {
+    CandidateProfiler::Scope profileScope("parseRecursively");
+    //Each candidate gets a fresh arena, the last candidate's nodes are done with
+    this->arena.reset();
+    //Build the tree for the arguments once, then walk it down to the leaves
     std::string expression = this->getExpression(functionName, lineNumber);
-    //Return the parsed variables
-    return this->parseExpression(expression);
-}
-
-std::vector<std::string> JavaParser::parseExpression(const std::string& expression) {
-    //Make a vector for the variables
-    std::vector<std::string> variables;
-    //If there is no expression, we can just exit now
-    if (expression.empty())
-        return variables;
-    //Split the expression first by function arguments
-    std::vector<std::string> parts = Util::splitNotAtDepth(expression, ",");
-    for (const std::string& s : parts) {
-        //Then split each by the string addition "+" and add to variables
-        for (const std::string& spart : Util::splitNotAtDepth(s, "+")) {
-            variables.push_back(Util::trim(spart));
+    std::string currentFunction = this->getFunctionName(lineNumber);
+    std::vector<const ExpressionNode*> leaves;
+    ExpressionParser parser(this->arena);
+    for (const ExpressionNode* node = parser.parse(expression); node != NULL; node = node->next)
+        this->collectLeaves(node, currentFunction, leaves);
+    return leaves;
+}
+
+//Values read out of the function's text are parsed once into the arena, then walked like the candidate's
+std::vector<const ExpressionNode*> JavaParser::parseRecursively(const std::vector<std::string>& parts,
+        const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("parseRecursively");
+    std::vector<const ExpressionNode*> leaves;
+    ExpressionParser parser(this->arena);
+    for (const std::string& part : parts)
+        for (const ExpressionNode* node = parser.parse(part); node != NULL; node = node->next)
+            this->collectLeaves(node, functionName, leaves);
+    return leaves;
+}
+
+//Parse a value read out of the function's text into one node. If the tree doesn't cover the
+//text as a single node, like "(a)" or "a, b", the text is kept whole with the tree as children,
+//so its type is still found from all of it
+const ExpressionNode* JavaParser::parseValue(const std::string& value) {
+    std::string text = Util::trim(value);
+    ExpressionParser parser(this->arena);
+    ExpressionNode* first = parser.parse(text);
+    if ((first != NULL) && (first->next == NULL) && (first->length == text.length()))
+        return first;
+    ExpressionNode* whole = this->arena.allocate(ExpressionNode::Unknown, this->arena.copy(text), text.length());
+    whole->firstChild = first;
+    return whole;
+}
+
+void JavaParser::collectLeaves(const ExpressionNode* node, const std::string& functionName,
+        std::vector<const ExpressionNode*>& leaves) {
+    if (!this->spend())
+        return;
+    switch (node->kind) {
+        //Concatenations and array initializers are just their parts, as is text parseValue kept whole
+        case ExpressionNode::Unknown:
+            if (node->firstChild == NULL) {
+                leaves.push_back(node);
+                break;
+            }
+        case ExpressionNode::Concatenation:
+        case ExpressionNode::ArrayInitializer:
+            for (const ExpressionNode* child = node->firstChild; child != NULL; child = child->next)
+                this->collectLeaves(child, functionName, leaves);
+            break;
+        //Calls depend on what they are called on and all of their arguments
+        case ExpressionNode::Call:
+            if (node->target != NULL) {
+                //The owner of a call is looked up by the name before its first '.'
+                if (node->target->kind == ExpressionNode::Name && node->target->target == NULL) {
+                    const ExpressionNode* owner = node->target;
+                    const char* dot = std::find(owner->text, owner->text + owner->length, '.');
+                    if (dot != owner->text + owner->length)
+                        owner = this->arena.allocate(ExpressionNode::Name, owner->text, dot - owner->text);
+                    leaves.push_back(owner);
+                }
+                else {
+                    this->collectLeaves(node->target, functionName, leaves);
+                }
+            }
+            for (const ExpressionNode* child = node->firstChild; child != NULL; child = child->next)
+                this->collectLeaves(child, functionName, leaves);
+            break;
+        //A cast has the value of whatever it casts
+        case ExpressionNode::Cast:
+            this->collectLeaves(node->firstChild, functionName, leaves);
+            break;
+        //new with an array initializer is its elements, otherwise the new object itself
+        case ExpressionNode::New:
+            if (node->firstChild != NULL)
+                this->collectLeaves(node->firstChild, functionName, leaves);
+            else
+                leaves.push_back(node);
+            break;
+        //Names of String arrays are followed to their { } declaration if there is one
+        case ExpressionNode::Name: {
+            if (node->target != NULL) {
+                this->collectLeaves(node->target, functionName, leaves);
+                break;
+            }
+            std::string name = node->getText();
+            Symbol type = this->findType(name, functionName);
+            if (type == Symbols::Empty)
+                type = this->findMemberType(name);
+            std::string stringArr;
+            if (type == Symbols::StringArray)
+                stringArr = this->getStringArr(name, functionName);
+            if (stringArr.empty()) {
+                leaves.push_back(node);
+                break;
+            }
+            ExpressionParser parser(this->arena);
+            for (const ExpressionNode* child = parser.parse(stringArr); child != NULL; child = child->next)
+                this->collectLeaves(child, functionName, leaves);
+            break;
         }
+        //Literals and anything that couldn't be parsed can't be split any further
+        default:
+            leaves.push_back(node);
+            break;
+    }
+}
+
+//A copy, since summaries can still change under the lock once it's let go
+MethodSummary JavaParser::getSummary(const std::string& functionName) {
+    std::lock_guard<std::recursive_mutex> guard(this->fileIndex->summaryLock);
+    MethodSummary* summary = this->findSummary(functionName);
+    if (summary == NULL)
+        return MethodSummary();
+    return *summary;
+}
+
+//Methods are summarized one at a time, the first time anything is asked about them
+//Only the header and its exec calls are read here, the overloads and call sites that take
+//the rest of the file wait until a question needs them. Callers hold the summary lock
+MethodSummary* JavaParser::findSummary(const std::string& functionName) {
+    std::map<std::string, MethodSummary>::iterator found = this->summaries.find(functionName);
+    if (found != this->summaries.end())
+        return &found->second;
+    const std::string& functionBody = this->readFunction(functionName);
+    if (functionBody.empty())
+        return NULL;
+    CandidateProfiler::Scope profileScope("findSummary");
+    MethodSummary& summary = this->summaries[functionName];
+    summary.overloadsChecked = false;
+    summary.isAmbiguous = false;
+    summary.callSitesFound = false;
+    summary.returnsResolved = false;
+    summary.returnHardcoded = false;
+    std::string functionHeader = functionBody.substr(0, functionBody.find("{"));
+    summary.isPrivate = (Util::regexFind(functionHeader, "\\bprivate ") != std::string::npos);
+    summary.parameters = readParameters(functionHeader, functionName);
+    summary.parameterSources.assign(summary.parameters.size(), MethodSummary::Unresolved);
+    summary.provisionalSources.assign(summary.parameters.size(), MethodSummary::FromOther);
+    //Any parameter used inside an exec call of this method flows into exec
+    int functionStart = this->javaReader.getFunctionBounds(functionName).first;
+    size_t execLocation = 0;
+    while ((execLocation = functionBody.find(".exec(", execLocation)) != std::string::npos) {
+        int lineNumber = functionStart + std::count(functionBody.begin(),
+                functionBody.begin() + execLocation, '\n');
+        execLocation++;
+        std::string expression = this->getExpression("exec", lineNumber);
+        for (int i = 0; i < summary.parameters.size(); i++)
+            if (Util::regexFind(expression, "\\b" + Util::escapeRegex(summary.parameters[i]) + "\\b")
+                    != std::string::npos)
+                summary.execParameters.insert(i);
+    }
+    return &summary;
+}
+
+//Bodies are looked up by name, so calls are told apart from other overloads by their
+//number of arguments. If another overload takes as many, a call could be either one,
+//so the summary claims nothing: its callers aren't used and its returns aren't hardcoded
+bool JavaParser::isAmbiguous(const std::string& functionName, MethodSummary& summary) {
+    if (!summary.overloadsChecked) {
+        summary.isAmbiguous = this->hasSameArityOverload(functionName, summary.parameters.size());
+        summary.overloadsChecked = true;
     }
-    return variables;    
-}
-
-std::vector<std::string> JavaParser::parseStringArr(const std::string& stringArr) {
-    //Get the inside without the { } part
-    int arrStart = stringArr.find_first_of("{") + 1;
-    int arrEnd = stringArr.find_last_of("}");
-    std::string contents = stringArr.substr(arrStart, arrEnd - arrStart);
-    //Split the inside not at depth by , to get the parts of the array
-    std::vector<std::string> parts = Util::splitNotAtDepth(contents, ",");
-    //Trim each of the strings and return
-    for (std::string& s : parts)
-        s = Util::trim(s);
-    return parts;
-}
-
-std::vector<std::string> JavaParser::parseFunction(const std::string& function) {
-    std::vector<std::string> parts;
-    //Check whether it is a member function
-    if (function.find(".") != std::string::npos) {
-        //If there is and it's not inside the arguments, add it to parts
-        if (function.find(".") < function.find("(")) {
-            std::string owner = function.substr(0, function.find("."));
-            parts.push_back(owner);
+    return summary.isAmbiguous;
+}
+
+//Collect the calls made to one method from every method of the file
+void JavaParser::findCallSites(const std::string& callee, MethodSummary& summary) {
+    CandidateProfiler::Scope profileScope("findCallSites");
+    summary.callSitesFound = true;
+    for (const std::string& caller : this->javaReader.readFunctionNames()) {
+        const std::string& functionBody = this->readFunction(caller);
+        size_t bodyStart = functionBody.find("{");
+        if (bodyStart == std::string::npos)
+            continue;
+        char quote = 0;
+        for (size_t i = bodyStart; i < functionBody.length(); i++) {
+            char c = functionBody[i];
+            //Skip over anything inside a string or char literal
+            if (quote) {
+                if (c == '\\')
+                    i++;
+                else if (c == quote)
+                    quote = 0;
+                continue;
+            }
+            if ((c == '"') || (c == '\'')) {
+                quote = c;
+                continue;
+            }
+            //Look for the start of an identifier
+            if (!isWordChar(c) || ((c >= '0') && (c <= '9')) || isWordChar(functionBody[i-1]))
+                continue;
+            size_t nameEnd = i;
+            while ((nameEnd < functionBody.length()) && isWordChar(functionBody[nameEnd]))
+                nameEnd++;
+            size_t nameStart = i;
+            size_t open = functionBody.find_first_not_of(" ", nameEnd);
+            i = nameEnd - 1;
+            if ((open == std::string::npos) || (functionBody[open] != '(') ||
+                    functionBody.compare(nameStart, nameEnd - nameStart, callee))
+                continue;
+            //Calls on other objects are different methods, unless it's this.method()
+            size_t before = functionBody.find_last_not_of(" ", i - 1);
+            if ((before != std::string::npos) && (functionBody[before] == '.') &&
+                    !Util::endsWith(functionBody.substr(0, before), "this"))
+                continue;
+            //Find the matching close parenthesis for the argument list
+            int parenDepth = 0;
+            size_t close = open;
+            for (; close < functionBody.length(); close++) {
+                if (functionBody[close] == '(')
+                    parenDepth++;
+                else if (functionBody[close] == ')' && --parenDepth == 0)
+                    break;
+            }
+            if (close >= functionBody.length())
+                continue;
+            CallSite site;
+            site.caller = caller;
+            std::string argumentList = Util::trim(functionBody.substr(open + 1, close - open - 1));
+            if (!argumentList.empty())
+                for (const std::string& argument : Util::splitNotAtDepth(argumentList, ","))
+                    site.arguments.push_back(Util::trim(argument));
+            //Overloads with a different number of arguments are not the same method
+            if (site.arguments.size() == summary.parameters.size())
+                summary.callSites.push_back(site);
         }
     }
-    //Otherwise we need to look for all function arguments in the chain
-    int parenDepth = 0;
-    int argStart = 0;
-    for (int i = 0; i < function.length(); i++) {
-        //Open increases depth
-        if (function[i] == '(') {
-            if (parenDepth == 0)
-                argStart = i + 1;
-            parenDepth++;
+}
+
+//Resolving a summary counts against the budgets of the candidate that asked, it's the deep
+//part of the work they bound. One cut short by a budget isn't kept, see endResolution
+void JavaParser::beginResolution(const std::string& functionName, int index) {
+    Resolution resolution = { functionName, index, std::string::npos };
+    this->resolutions.push_back(resolution);
+}
+
+//Whether what the innermost resolution found is final. It isn't when it came back around
+//to one further down, that one decides once it's done and this is worked out again after,
+//or when a budget ran out, the next candidate to ask works it out again
+bool JavaParser::endResolution() {
+    size_t position = this->resolutions.size() - 1;
+    size_t lowest = this->resolutions.back().lowest;
+    this->resolutions.pop_back();
+    if (this->isOverBudget())
+        return false;
+    if (lowest >= position)
+        return true;
+    this->resolutions.back().lowest = std::min(this->resolutions.back().lowest, lowest);
+    return false;
+}
+
+//Whether the returns (index -1) or parameter is being resolved further down, meaning
+//a call cycle came back around to it
+bool JavaParser::isResolving(const std::string& functionName, int index) {
+    for (size_t i = 0; i < this->resolutions.size(); i++) {
+        if ((this->resolutions[i].index == index) && (this->resolutions[i].functionName == functionName)) {
+            this->resolutions.back().lowest = std::min(this->resolutions.back().lowest, i);
+            return true;
         }
-        //Close decrease depth
-        else if (function[i] == ')') {
-            parenDepth--;
-            //If the depth returned to 0, that's the end of a set of arguments
-            if (parenDepth == 0) {
-                std::string expression = function.substr(argStart, i - argStart);
-                //Parse the expression and add each to parts
-                for (const std::string& s : this->parseExpression(expression))
-                    parts.push_back(Util::trim(s));
+    }
+    return false;
+}
+
+//Whether what the method returns is hardcoded, given hardcoded arguments for the
+//parameters it returns. Both are copied out, summaries only change under the lock
+bool JavaParser::resolveReturns(const std::string& functionName, std::set<int>& returnParameters) {
+    CandidateProfiler::Scope profileScope("resolveReturns");
+    std::lock_guard<std::recursive_mutex> guard(this->fileIndex->summaryLock);
+    MethodSummary& summary = *this->findSummary(functionName);
+    //A recursive method sees its own return as not hardcoded, whichever method the cycle was entered from
+    if (!summary.returnsResolved && !this->isResolving(functionName, -1)) {
+        if (this->isAmbiguous(functionName, summary))
+            summary.returnsResolved = true;
+        else
+            this->findReturns(functionName, summary);
+    }
+    returnParameters = summary.returnParameters;
+    return summary.returnHardcoded;
+}
+
+void JavaParser::findReturns(const std::string& functionName, MethodSummary& summary) {
+    const std::string& functionBody = this->readFunction(functionName);
+    size_t position = this->resolutions.size();
+    this->beginResolution(functionName, -1);
+    long changes;
+    do {
+        changes = this->provisionalChanges;
+        this->resolutions.back().lowest = std::string::npos;
+        summary.returnHardcoded = false;
+        summary.returnParameters.clear();
+        bool hardcoded = true;
+        bool hasReturn = false;
+        int location = functionBody.find("{");
+        while ((location = Util::regexFind(functionBody, "\\breturn\\b", location + 1)) != std::string::npos) {
+            int expressionStart = location + 6;
+            int expressionEnd = findStatementEnd(functionBody, expressionStart);
+            if (expressionEnd == std::string::npos)
+                break;
+            std::string expression = Util::trim(functionBody.substr(expressionStart, expressionEnd - expressionStart));
+            if (expression.empty())
+                continue;
+            hasReturn = true;
+            //Parameters are remembered, anything else has to be hardcoded itself
+            for (const ExpressionNode* leaf : this->parseRecursively(std::vector<std::string>(1, expression), functionName)) {
+                std::vector<std::string>::const_iterator parameter = std::find(
+                        summary.parameters.begin(), summary.parameters.end(), leaf->getText());
+                if (parameter != summary.parameters.end())
+                    summary.returnParameters.insert(parameter - summary.parameters.begin());
+                else if (!this->isHardcoded(leaf, functionName))
+                    hardcoded = false;
             }
         }
-    }
-    return parts;
+        summary.returnHardcoded = hasReturn && hardcoded;
+    //A cycle that came back around to here is worked out again until its parameters stop changing
+    } while ((this->resolutions.back().lowest == position) && (this->provisionalChanges != changes) &&
+            !this->isOverBudget());
+    summary.returnsResolved = this->endResolution();
 }
 
-std::vector<std::string> JavaParser::parseRecursively(const std::string& functionName, int lineNumber) {
-    //Assumed to start on an expression, so we get the first parts
-    std::vector<std::string> parts = this->parseExpression(functionName, lineNumber);
-    std::string currentFunction = this->getFunctionName(lineNumber);
-    //Get the function name, and let the private recursive function handle it
-    return this->parseRecursively(parts, currentFunction);
-}
-
-std::vector<std::string> JavaParser::parseRecursively(const std::vector<std::string>& parts, const std::string& functionName) {
-    std::vector<std::string> returnParts;
-    //For each thing in parts, we need to try and split it and then call parseRecursively on that
-    for (const std::string& part : parts) {
-        //Get the type so we know how to parse it
-        std::string type = this->findType(part, functionName);
-        //Get member type if type not available
-        if (type.empty())
-            type = findMemberType(part);
-        //If String[], parse String Array
-        if (type == "String[]") {
-            std::string stringArr = this->getStringArr(part, functionName);
-            //If there is no { } to parse just add the array
-            if (stringArr.empty()) {
-                returnParts.push_back(Util::trim(part));
+//Parameters in a cycle only ever become more tainted as it's worked out
+static int sourceRank(MethodSummary::Source source) {
+    if (source == MethodSummary::FromInput)
+        return 2;
+    if (source == MethodSummary::FromOther)
+        return 1;
+    return 0;
+}
+
+//Where a parameter's values come from, over every call site. A call cycle can't show that a
+//parameter is hardcoded, so each one in it starts out as other and is worked out again until
+//none change, giving the same answers whichever method the cycle is entered from.
+//Callers hold the summary lock
+MethodSummary::Source JavaParser::resolveParameter(const std::string& functionName, int index) {
+    CandidateProfiler::Scope profileScope("resolveParameter");
+    MethodSummary& summary = this->summaries.at(functionName);
+    if (this->isResolving(functionName, index))
+        return summary.provisionalSources[index];
+    if (summary.parameterSources[index] != MethodSummary::Unresolved)
+        return summary.parameterSources[index];
+    summary.parameterSources[index] = MethodSummary::Resolving;
+    size_t position = this->resolutions.size();
+    this->beginResolution(functionName, index);
+    MethodSummary::Source source;
+    long changes;
+    do {
+        changes = this->provisionalChanges;
+        this->resolutions.back().lowest = std::string::npos;
+        //Any caller passing input taints it, any non-hardcoded caller makes it other
+        source = MethodSummary::FromHardcoded;
+        for (const CallSite& site : summary.callSites) {
+            std::vector<std::string> parts(1, site.arguments[index]);
+            //Calls to methods of this file only pass on the parameters they return
+            std::string callee;
+            std::vector<std::string> arguments;
+            if (this->isLocalCall(parts[0], callee, arguments)) {
+                std::set<int> returnParameters;
+                if (!this->resolveReturns(callee, returnParameters))
+                    source = MethodSummary::FromOther;
+                parts.clear();
+                for (int returned : returnParameters)
+                    parts.push_back(arguments[returned]);
             }
-            //Otherwise parse the { } and then return parseRecursively on that
-            else {
-                std::vector<std::string> stringArrParts = this->parseStringArr(stringArr);
-                for (const std::string& s : this->parseRecursively(stringArrParts, functionName))
-                    returnParts.push_back(Util::trim(s));
+            for (const ExpressionNode* leaf : this->parseRecursively(parts, site.caller)) {
+                if (this->isInput(leaf, site.caller)) {
+                    source = MethodSummary::FromInput;
+                    break;
+                }
+                if (!this->isHardcoded(leaf, site.caller))
+                    source = MethodSummary::FromOther;
             }
+            if (source == MethodSummary::FromInput)
+                break;
         }
-        //If the type is a function, parse the function and parse that recursively
-        else if (type == "function") {
-            std::vector<std::string> functionParts = this->parseFunction(part);
-            for (const std::string& s : this->parseRecursively(functionParts, functionName))
-                returnParts.push_back(Util::trim(s));
-        }
-        //If the type is an expression, parse the expression and parse recursively
-        else if (type == "expression") {
-            std::vector<std::string> expressionParts = this->parseExpression(part);
-            for (const std::string& s : this->parseRecursively(expressionParts, functionName))
-                returnParts.push_back(Util::trim(s));
-        }
-        //Otherwise we've reached something that cannot be parsed further so return it
-        else {
-            returnParts.push_back(Util::trim(part));
+        if ((this->resolutions.back().lowest != std::string::npos) &&
+                (sourceRank(source) > sourceRank(summary.provisionalSources[index]))) {
+            summary.provisionalSources[index] = source;
+            this->provisionalChanges++;
         }
+    } while ((this->resolutions.back().lowest == position) && (this->provisionalChanges != changes) &&
+            !this->isOverBudget());
+    summary.parameterSources[index] = this->endResolution() ? source : MethodSummary::Unresolved;
+    return source;
+}
+
+MethodSummary::Source JavaParser::getCallerSource(const std::string& variableName, const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("getCallerSource");
+    std::lock_guard<std::recursive_mutex> guard(this->fileIndex->summaryLock);
+    MethodSummary* summary = this->findSummary(functionName);
+    //Public methods can be called from anywhere, so only private ones are resolved
+    if ((summary == NULL) || !summary->isPrivate)
+        return MethodSummary::Unresolved;
+    std::vector<std::string>::const_iterator parameter = std::find(
+            summary->parameters.begin(), summary->parameters.end(), variableName);
+    if (parameter == summary->parameters.end())
+        return MethodSummary::Unresolved;
+    int index = parameter - summary->parameters.begin();
+    if (!summary->execParameters.count(index))
+        return MethodSummary::Unresolved;
+    //Only a private parameter that reaches exec needs the rest of the file read for its callers
+    if (this->isAmbiguous(functionName, *summary))
+        return MethodSummary::Unresolved;
+    if (!summary->callSitesFound)
+        this->findCallSites(functionName, *summary);
+    if (summary->callSites.empty())
+        return MethodSummary::Unresolved;
+    return this->resolveParameter(functionName, index);
+}
+
+bool JavaParser::isForwardedInput(const std::string& variableName, const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("isForwardedInput");
+    //Find where the variable is assigned inside the function
+    const std::string& functionBody = this->readFunction(functionName);
+    int location = Util::regexFind(functionBody, Util::escapeRegex(variableName) + " *= *.*;");
+    if (location == std::string::npos)
+        return false;
+    int decStart = functionBody.find("=", location) + 1;
+    int decEnd = findStatementEnd(functionBody, decStart);
+    std::string rightSide = Util::trim(functionBody.substr(decStart, decEnd - decStart));
+    //Only calls to methods of this file have a summary to go on
+    std::string callee;
+    std::vector<std::string> arguments;
+    if (!this->isLocalCall(rightSide, callee, arguments))
+        return false;
+    std::set<int> returnParameters;
+    this->resolveReturns(callee, returnParameters);
+    //The value is input if a returned parameter was given one of our inputs
+    for (int index : returnParameters)
+        for (const ExpressionNode* leaf : this->parseRecursively(
+                std::vector<std::string>(1, arguments[index]), functionName))
+            if ((leaf->getText() != variableName) && this->isInput(leaf, functionName))
+                return true;
+    return false;
+}
+
+bool JavaParser::isLocalCall(const std::string& expression, std::string& callee, std::vector<std::string>& arguments) {
+    //Expect name(arguments) or this.name(arguments) and nothing else
+    std::string call = Util::trim(expression);
+    if (Util::startsWith(call, "this."))
+        call = call.substr(5);
+    size_t open = call.find("(");
+    if ((open == std::string::npos) || !Util::endsWith(call, ")"))
+        return false;
+    callee = Util::trim(call.substr(0, open));
+    if (callee.empty() || (callee.find_first_not_of(
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_") != std::string::npos))
+        return false;
+    //The parenthesis has to close at the very end, not earlier in a chain
+    int parenDepth = 0;
+    for (size_t i = open; i < call.length(); i++) {
+        if (call[i] == '(')
+            parenDepth++;
+        else if (call[i] == ')' && --parenDepth == 0 && i != call.length() - 1)
+            return false;
+    }
+    arguments.clear();
+    std::string argumentList = Util::trim(call.substr(open + 1, call.length() - open - 2));
+    if (!argumentList.empty())
+        for (const std::string& argument : Util::splitNotAtDepth(argumentList, ","))
+            arguments.push_back(Util::trim(argument));
+    //It also has to be a method of this file with the same number of arguments
+    std::lock_guard<std::recursive_mutex> guard(this->fileIndex->summaryLock);
+    MethodSummary* summary = this->findSummary(callee);
+    return (summary != NULL) && (arguments.size() == summary->parameters.size());
+}
+
+//Whether a different overload of the method than the one read in takes the same number of parameters
+bool JavaParser::hasSameArityOverload(const std::string& functionName, size_t parameterCount) {
+    std::vector<std::pair<int,int>> overloads = this->javaReader.getOverloadBounds(functionName);
+    if (overloads.size() < 2)
+        return false;
+    std::pair<int,int> summarized = this->javaReader.getFunctionBounds(functionName);
+    for (const std::pair<int,int>& bounds : overloads) {
+        if (bounds == summarized)
+            continue;
+        std::string functionBody = this->javaReader.readLines(bounds);
+        std::string functionHeader = functionBody.substr(0, functionBody.find("{"));
+        if (readParameters(functionHeader, functionName).size() == parameterCount)
+            return true;
     }
-    //Return the result of all of the leafs of the recursive parsing
-    return returnParts;
-}
\ No newline at end of file
+    return false;
+}
+
+//Count a step against the budgets, false once either has run out
+bool JavaParser::spend() {
+    bool candidateLeft = (this->candidateBudget == NULL) || this->candidateBudget->spend();
+    bool fileLeft = (this->fileBudget == NULL) || this->fileBudget->spend();
+    return candidateLeft && fileLeft;
+}
+
+//Build a function's filter from the same text findType scans
+const IdentifierFilter& JavaParser::getFunctionFilter(const std::string& functionName) {
+    std::map<std::string, IdentifierFilter>::iterator found = this->functionFilters.find(functionName);
+    if (found == this->functionFilters.end())
+        found = this->functionFilters.insert(std::make_pair(functionName,
+                IdentifierFilter::forLocals(this->readFunction(functionName)))).first;
+    return found->second;
+}
+
+//The text before the constructor where members are declared, read once per parser with its filter
+const std::string& JavaParser::readMembers() {
+    if (!this->membersRead) {
+        //Get the class name so we can find where the constructor is
+        //Hoping good style is used, member functions should be before it
+        std::string className = this->javaReader.getClassName();
+        int endOfMembers = this->javaReader.getFunctionBounds(className).first - 1;
+        //If the file doesn't have a constructor than this is the failure value
+        if (endOfMembers == -2)
+            endOfMembers = 1000;
+        //Extract all of the text between the start of the file and the constructor
+        this->memberRegion = this->javaReader.readLines(std::pair<int,int>(1,endOfMembers));
+        this->memberFilter = IdentifierFilter::forMembers(this->memberRegion);
+        this->membersRead = true;
+    }
+    return this->memberRegion;
+}
+
+//The class variables checked for a hardcoded value, the same text before the constructor,
+//but without a constructor there are none to check
+const std::string& JavaParser::readClassVariables() {
+    if (!this->classVariablesRead) {
+        int classVarEnd = this->javaReader.getFunctionBounds(this->javaReader.getClassName()).first - 1;
+        this->classVariables = this->javaReader.readLines(std::pair<int,int>(1, classVarEnd));
+        this->classVariablesRead = true;
+    }
+    return this->classVariables;
+}
+
+//Ask a filter about the first nameLength characters of the name, counting what it rules out
+//A name that doesn't start with an identifier can't be looked up, so it's never ruled out
+bool JavaParser::mightDeclare(const IdentifierFilter& filter, const std::string& variableName, size_t nameLength) {
+    if (nameLength == 0)
+        return true;
+    this->fileIndex->filterLookups++;
+    if (filter.mightContain(variableName.data(), nameLength))
+        return true;
+    this->fileIndex->filterRejections++;
+    return false;
+}
+
+//Function bodies are read out of the file once per parser and then reused,
+//the map never moves them so the references stay good during recursion
+const std::string& JavaParser::readFunction(const std::string& functionName) {
+    CandidateProfiler::Scope profileScope("readFunction");
+    std::map<std::string, std::string>::iterator found = this->functionBodies.find(functionName);
+    if (found == this->functionBodies.end())
+        found = this->functionBodies.insert(std::make_pair(functionName,
+                this->javaReader.readFunction(functionName))).first;
+    return found->second;
+}
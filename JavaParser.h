@@ -32,30 +32,128 @@
 #ifndef JAVAPARSER_H
 #define JAVAPARSER_H
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
+#include "IdentifierFilter.h"
+#include "JavaExpression.h"
 #include "JavaReader.h"
+#include "WorkBudget.h"
 
+//A call to a method of this file, made from inside another method
+struct CallSite {
+    std::string caller;
+    std::vector<std::string> arguments;
+};
+
+//What a method does with its parameters, worked out once per file a part at a time
+struct MethodSummary {
+    enum Source { Unresolved, Resolving, FromInput, FromHardcoded, FromOther };
+    bool isPrivate;
+    bool overloadsChecked;
+    bool isAmbiguous;
+    bool callSitesFound;
+    bool returnsResolved;
+    bool returnHardcoded;
+    std::vector<std::string> parameters;
+    std::set<int> execParameters;
+    std::set<int> returnParameters;
+    std::vector<CallSite> callSites;
+    std::vector<Source> parameterSources;
+    //What each parameter has been found to be so far while a call cycle is worked out
+    std::vector<Source> provisionalSources;
+};
+
+//The parts of a file that threads analyzing it can share
+//The reader never changes, summaries are built a method at a time and only under the lock
+struct JavaFileIndex {
+    JavaFileIndex(const std::string& filePath);
+    JavaFileIndex(const std::string& filePath, std::string& contents);
+    JavaFileIndex(const std::string& filePath, const ProjectSnapshot::File& file);
+    const JavaReader javaReader;
+    std::recursive_mutex summaryLock;
+    std::map<std::string, MethodSummary> summaries;
+    //Declaration lookups the identifier filters were asked about, and how many they ruled out
+    std::atomic<long> filterLookups;
+    std::atomic<long> filterRejections;
+};
+
+//A JavaParser is a cheap query context, give each thread its own over a shared index
 class JavaParser {
 public:
     JavaParser(const std::string& filePath);
+    JavaParser(const std::string& filePath, std::string& contents);
+    JavaParser(const std::shared_ptr<JavaFileIndex>& fileIndex);
+    std::shared_ptr<JavaFileIndex> getFileIndex();
     std::string getFunctionName(int lineNumber);
+    void prepareFunction(const std::string& functionName);
+    void setBudgets(WorkBudget* candidateBudget, WorkBudget* fileBudget);
+    bool isOverBudget() const;
     std::string getFullStatement(int lineNumber);
-    std::string findType(const std::string& variableName, const std::string& functionName);
-    std::string findMemberType(const std::string& variableName);
-    bool isInput(const std::string& variableName, const std::string& functionName);
-    bool isHardcoded(const std::string& variableName, const std::string& functionName);
+    Symbol findType(const std::string& variableName, const std::string& functionName, bool reported = false);
+    Symbol findType(const ExpressionNode* node, const std::string& functionName, bool reported = false);
+    Symbol findMemberType(const std::string& variableName, bool reported = false);
+    bool isInput(const ExpressionNode* node, const std::string& functionName);
+    bool isHardcoded(const ExpressionNode* node, const std::string& functionName);
     bool isCommented(int lineNumber);
     std::string getExpression(const std::string& functionName, int lineNumber);
     std::string getStringArr(const std::string& stringArrName, const std::string& functionName);
-    std::vector<std::string> parseExpression(const std::string& functionName, int lineNumber);
-    std::vector<std::string> parseExpression(const std::string& expression);
-    std::vector<std::string> parseStringArr(const std::string& stringArr);
-    std::vector<std::string> parseFunction(const std::string& function);
-    std::vector<std::string> parseRecursively(const std::string& functionName, int lineNumber);
+    std::vector<const ExpressionNode*> parseRecursively(const std::string& functionName, int lineNumber);
+    MethodSummary getSummary(const std::string& functionName);
 private:
-    JavaReader javaReader;
-    std::vector<std::string> parseRecursively(const std::vector<std::string>& parts, const std::string& functionName);
+    std::shared_ptr<JavaFileIndex> fileIndex;
+    const JavaReader& javaReader;
+    std::map<std::string, MethodSummary>& summaries;
+    std::map<std::string, std::string> functionBodies;
+    //Names each function and the class members could declare, built the first time they're looked in
+    std::map<std::string, IdentifierFilter> functionFilters;
+    bool membersRead;
+    std::string memberRegion;
+    IdentifierFilter memberFilter;
+    bool classVariablesRead;
+    std::string classVariables;
+    WorkBudget* candidateBudget;
+    WorkBudget* fileBudget;
+    bool spend();
+    Symbol typeSymbol(const std::string& typeName, bool reported) const;
+    const std::string& readFunction(const std::string& functionName);
+    const IdentifierFilter& getFunctionFilter(const std::string& functionName);
+    const std::string& readMembers();
+    const std::string& readClassVariables();
+    bool mightDeclare(const IdentifierFilter& filter, const std::string& variableName, size_t nameLength);
+    MethodSummary* findSummary(const std::string& functionName);
+    bool isAmbiguous(const std::string& functionName, MethodSummary& summary);
+    bool hasSameArityOverload(const std::string& functionName, size_t parameterCount);
+    void findCallSites(const std::string& callee, MethodSummary& summary);
+    //A returns (index -1) or parameter being resolved, and the lowest one below it that a
+    //call cycle came back around to from it or anything resolved on top of it
+    struct Resolution {
+        std::string functionName;
+        int index;
+        size_t lowest;
+    };
+    std::vector<Resolution> resolutions;
+    long provisionalChanges;
+    void beginResolution(const std::string& functionName, int index);
+    bool endResolution();
+    bool isResolving(const std::string& functionName, int index);
+    bool resolveReturns(const std::string& functionName, std::set<int>& returnParameters);
+    void findReturns(const std::string& functionName, MethodSummary& summary);
+    MethodSummary::Source resolveParameter(const std::string& functionName, int index);
+    MethodSummary::Source getCallerSource(const std::string& variableName, const std::string& functionName);
+    bool isForwardedInput(const std::string& variableName, const std::string& functionName);
+    bool isLocalCall(const std::string& expression, std::string& callee, std::vector<std::string>& arguments);
+    ExpressionArena arena;
+    std::vector<const ExpressionNode*> parseRecursively(const std::vector<std::string>& parts,
+            const std::string& functionName);
+    const ExpressionNode* parseValue(const std::string& value);
+    bool areLeavesHardcoded(const ExpressionNode* node, const std::string& functionName);
+    void collectLeaves(const ExpressionNode* node, const std::string& functionName,
+            std::vector<const ExpressionNode*>& leaves);
 };
 
 #endif /* JAVAPARSER_H */
@@ -30,174 +30,450 @@
  */
 
 #include <algorithm>
+#include <iterator>
 #include "JavaReader.h"
+#include "StructuralIndex.h"
 #include "Utility.h"
+#include "ZipArchive.h"
+
+//How many lines the structural scan does at a time, ahead of the lazy index
+static const int structureChunkLines = 256;
 
 #include <iostream>
 
 JavaReader::JavaReader(const std::string& filePath) : 
-        fileStream(std::ifstream(filePath)),
-        functions(std::map<std::string, std::vector<std::pair<int,int>>>()) {
-    //Keep track of file position and nesting depth
-    int blockDepth = 0;
-    int lineNumber = 0;
+        functions(std::unordered_map<Symbol, std::vector<std::pair<int,int>>>()) {
+    //Read the whole file into memory once, every later read comes from the buffer
+    std::ifstream fileStream;
+    if (!ZipArchive::readFile(filePath, this->ownedBuffer))
+        fileStream.open(filePath);
+    if (fileStream)
+        this->ownedBuffer.assign(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+    this->index();
+}
+
+//Takes over a buffer that was already read, such as one from the prefetcher
+JavaReader::JavaReader(const std::string& /*filePath*/, std::string& contents) : 
+        functions(std::unordered_map<Symbol, std::vector<std::pair<int,int>>>()) {
+    this->ownedBuffer.swap(contents);
+    this->index();
+}
+
+//Reads a file in place out of a snapshot, whose line starts are already worked out
+//The snapshot has to stay open for as long as the reader is used
+JavaReader::JavaReader(const std::string& /*filePath*/, const ProjectSnapshot::File& file) :
+        functions(std::unordered_map<Symbol, std::vector<std::pair<int,int>>>()) {
+    this->buffer = file.contents;
+    this->bufferSize = file.length;
+    this->lineStarts = file.lineStarts;
+    this->lineCount = file.lineCount;
+    this->resetIndex();
+}
+
+void JavaReader::index() {
+    this->buffer = this->ownedBuffer.data();
+    this->bufferSize = this->ownedBuffer.size();
+    //Record where every line starts so lines can be read without rescanning
+    StructuralIndex::findLineStarts(this->buffer, this->bufferSize, this->ownedLineStarts);
+    this->lineStarts = this->ownedLineStarts.data();
+    this->lineCount = this->ownedLineStarts.size();
+    this->resetIndex();
+}
+
+void JavaReader::resetIndex() {
+    //The structure of the file is only indexed as lookups ask for it
+    this->indexedLines = 0;
+    this->indexState = FindingClass;
+    this->blockDepth = 0;
+    this->internalClassDepth = 0;
+    this->functionStart = 0;
+};
+
+//\w in the patterns below
+static bool isWordChar(char c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+//Where "class [A-Z]\w+" first matches in the line, or npos
+static size_t findClassDeclaration(const char* text, size_t length) {
+    const char* keyword = "class ";
+    const char* end = text + length;
+    for (const char* found = std::search(text, end, keyword, keyword + 6); found != end;
+            found = std::search(found + 1, end, keyword, keyword + 6)) {
+        if ((found + 7 < end) && (found[6] >= 'A') && (found[6] <= 'Z') && isWordChar(found[7]))
+            return found - text;
+    }
+    return std::string::npos;
+}
+
+//Whether the line has a " \w+\(", which is all "(public|private|protected)?[^=\.]* \w+\("
+//needs to match somewhere, since everything before the space can match nothing
+static bool hasFunctionDeclaration(const char* text, size_t length) {
+    for (size_t i = 1; i < length; i++) {
+        if (text[i] != '(')
+            continue;
+        size_t j = i;
+        while ((j > 0) && isWordChar(text[j-1]))
+            j--;
+        if ((j < i) && (j > 0) && (text[j-1] == ' '))
+            return true;
+    }
+    return false;
+}
+
+//Index one more line of the file, picking up from where the last call stopped
+//Returns false once the whole file has been indexed
+bool JavaReader::indexNextLine() const {
+    if (this->indexState == Indexed)
+        return false;
+    if (this->indexedLines >= this->lineCount) {
+        this->indexState = Indexed;
+        return false;
+    }
+    this->indexedLines++;
+    //Braces and parentheses come from the structural scan, the text is only looked at
+    //where that says a pattern could be there
+    const StructuralIndex::Line& structure = this->getLineStructure(this->indexedLines);
+    const char* text;
+    size_t length;
+    this->getLineText(this->indexedLines, text, length);
     //Read until we find the start of the class definition
-    std::string line;
-    while (getline(this->fileStream,line)) {
-        lineNumber++;
+    if (this->indexState == FindingClass) {
         //Find the start of the class
-        if (Util::regexFind(line, "class [A-Z]\\w+") != std::string::npos) {
+        size_t classStart = findClassDeclaration(text, length);
+        if (classStart != std::string::npos) {
+            std::string line(text, length);
             //Find the position of the class name on the line
-            int classStart = Util::regexFind(line, "class [A-Z]\\w+");
             int nameStart = line.find(" ", classStart) + 1;
             int nameEnd = line.find(" ", nameStart);
             //Store the class name in this->className
             this->className = line.substr(nameStart, nameEnd - nameStart);
             //Start reading after class block starts
-            while (line.find("{") == std::string::npos) {
-                lineNumber++;
-                getline(this->fileStream,line);
-            }
-            break;
+            if (structure.openBraces == 0)
+                this->indexState = OpeningClass;
+            else
+                this->indexState = ReadingMembers;
         }
+        return true;
+    }
+    if (this->indexState == OpeningClass) {
+        if (structure.openBraces > 0)
+            this->indexState = ReadingMembers;
+        return true;
     }
-    //Keep track of current function and where it started
-    int functionStart;
-    int internalClassDepth = 0;
-    std::string currentFunctionName;
-    while (getline(this->fileStream,line)) {
-        lineNumber++;
-        if (blockDepth == internalClassDepth) {
-            //Search for function definitions using regex
-            //"(public|private|protected )", functions should start with a modifier
-            //"[^=\\.]+" covers any return type and modifiers, and avoids variables
-            //" \\w+\\(" should capture the function name, with the '(' being the tell
-            if (Util::regexFind(line, "(public|private|protected)?[^=\\.]* \\w+\\(")
-                    != std::string::npos) {
-                functionStart = lineNumber;
-                int nameEnd = line.find("(");
-                int nameStart = line.rfind(" ", nameEnd) + 1;
-                currentFunctionName = line.substr(nameStart, nameEnd - nameStart);
-            }
+    if (this->blockDepth == this->internalClassDepth) {
+        //Search for function definitions, a modifier and return type followed by
+        //" name(", with the '(' being the tell
+        if (structure.hasParenthesis && hasFunctionDeclaration(text, length)) {
+            std::string line(text, length);
+            this->functionStart = this->indexedLines;
+            int nameEnd = line.find("(");
+            int nameStart = line.rfind(" ", nameEnd) + 1;
+            this->currentFunctionName = line.substr(nameStart, nameEnd - nameStart);
         }
-        int nextBlockDepth = blockDepth;
-        //Get the new block depth after the current line
-        std::string trimmed = Util::trim(line);
-        if (!Util::startsWith(trimmed, "*") && !Util::startsWith(trimmed, "//"))
-            nextBlockDepth = blockDepth + std::count(line.begin(), line.end(), '{')
-                    - std::count(line.begin(), line.end(), '}');
-        //If a function ended, since the block depth decreased
-        if ((blockDepth > internalClassDepth) && (nextBlockDepth <= internalClassDepth)) {
-            if (currentFunctionName.compare("")) {
-                //Create a new std::vector<std:pair<int,int>> just in case
-                std::vector<std::pair<int,int>> update;
-                if (this->functions.count(currentFunctionName))
-                    update = this->functions[currentFunctionName];
-                //Add this function to the map with its and end
-                update.push_back(std::pair<int,int>(functionStart, lineNumber));
-                this->functions[currentFunctionName] = update;
-                currentFunctionName = "";
-            }
+    }
+    int nextBlockDepth = this->blockDepth;
+    //Get the new block depth after the current line, comment lines don't count
+    if (!structure.startsAsComment)
+        nextBlockDepth = this->blockDepth + structure.openBraces - structure.closeBraces;
+    //If a function ended, since the block depth decreased
+    if ((this->blockDepth > this->internalClassDepth) && (nextBlockDepth <= this->internalClassDepth)) {
+        if (this->currentFunctionName.compare("")) {
+            //Add this function to the map with its start and end
+            Symbol functionName = Symbols::intern(this->currentFunctionName);
+            std::vector<std::pair<int,int>>& bounds = this->functions[functionName];
+            //Keep the functions in name order so lookups by line are the same every run
+            if (bounds.empty())
+                this->functionOrder.insert(std::lower_bound(this->functionOrder.begin(),
+                        this->functionOrder.end(), functionName, Symbols::lessByName), functionName);
+            bounds.push_back(std::pair<int,int>(this->functionStart, this->indexedLines));
+            this->currentFunctionName = "";
         }
-        //If a new internal class opened up, increase the depth
-        if (Util::regexFind(line, "class [A-Z]\\w+") != std::string::npos)
-            internalClassDepth++;
-        //If we have exceeded the bounds of the class, decrease depth
-        if (nextBlockDepth == internalClassDepth - 1)
-            internalClassDepth--;
-        blockDepth = nextBlockDepth;
     }
-};
-    
-std::string JavaReader::readLine(int lineNumber) {
+    //If a new internal class opened up, increase the depth
+    if (findClassDeclaration(text, length) != std::string::npos)
+        this->internalClassDepth++;
+    //If we have exceeded the bounds of the class, decrease depth
+    if (nextBlockDepth == this->internalClassDepth - 1)
+        this->internalClassDepth--;
+    this->blockDepth = nextBlockDepth;
+    return true;
+}
+
+//The structural scan runs ahead of the index a chunk of lines at a time
+const StructuralIndex::Line& JavaReader::getLineStructure(int lineNumber) const {
+    if (lineNumber > this->lineStructures.size())
+        StructuralIndex::scanLines(this->buffer, this->bufferSize, this->lineStarts, this->lineCount,
+                std::max(lineNumber, (int)this->lineStructures.size() + structureChunkLines),
+                this->lineStructures);
+    return this->lineStructures[lineNumber - 1];
+}
+
+//Index until the line has been passed and the function around it has closed
+//Functions found after that all start past the line, so none of them can hold it
+void JavaReader::indexThrough(int lineNumber) const {
+    while (((this->indexedLines < lineNumber) || this->currentFunctionName.compare(""))
+            && this->indexNextLine());
+}
+
+//Whether the lines within bounds hold a .exec( call, read straight from the buffer
+bool JavaReader::containsExec(std::pair<int,int> bounds) const {
+    int first = std::max(bounds.first, 1);
+    int last = std::min(bounds.second, (int)this->lineCount);
+    if (first > last)
+        return false;
+    size_t start = this->lineStarts[first - 1];
+    size_t end = (last < this->lineCount) ? this->lineStarts[last] : this->bufferSize;
+    const char* exec = ".exec(";
+    return std::search(this->buffer + start, this->buffer + end, exec, exec + 6)
+            != this->buffer + end;
+}
+
+//Point at a line without its newline, false once past the end of the file
+bool JavaReader::getLineText(int lineNumber, const char*& text, size_t& length) const {
+    if ((lineNumber < 1) || (lineNumber > this->lineCount))
+        return false;
+    int lineStart = this->lineStarts[lineNumber - 1];
+    int lineEnd = (lineNumber < this->lineCount) ?
+            this->lineStarts[lineNumber] - 1 : this->bufferSize;
+    //The last line may not end in a newline
+    if ((lineEnd > lineStart) && (lineEnd == this->bufferSize) && (this->buffer[lineEnd-1] == '\n'))
+        lineEnd--;
+    text = this->buffer + lineStart;
+    length = lineEnd - lineStart;
+    return true;
+}
+
+//Copy out a line without the newline, false once past the end of the file
+bool JavaReader::getRawLine(int lineNumber, std::string& line) const {
+    const char* text;
+    size_t length;
+    if (!this->getLineText(lineNumber, text, length))
+        return false;
+    line.assign(text, length);
+    return true;
+}
+
+int JavaReader::getLineCount() const {
+    return this->lineCount;
+}
+
+//Scan forward from the start of the line to the ';' ending the statement
+//Semicolons inside strings, char literals and comments don't count
+JavaStatement JavaReader::readStatement(int lineNumber) const {
+    JavaStatement statement;
+    statement.text = this->buffer + this->bufferSize;
+    statement.length = 0;
+    statement.firstLine = lineNumber;
+    statement.lastLine = lineNumber;
+    if ((lineNumber < 1) || (lineNumber > this->lineCount))
+        return statement;
+    size_t start = this->lineStarts[lineNumber - 1];
+    size_t end = this->bufferSize;
+    size_t i = start;
+    //A line that is commented out as a whole is still read as the code it holds
+    while ((i < end) && ((this->buffer[i] == ' ') || (this->buffer[i] == '\t')))
+        i++;
+    if ((i + 1 < end) && (this->buffer[i] == '/') && (this->buffer[i+1] == '/'))
+        i += 2;
+    int currentLine = lineNumber;
+    for (; i < end; i++) {
+        char c = this->buffer[i];
+        if (c == '\n') {
+            currentLine++;
+        }
+        else if ((c == '"') || (c == '\'')) {
+            //Skip to the matching quote, stepping over escaped characters
+            for (i++; (i < end) && (this->buffer[i] != c) && (this->buffer[i] != '\n'); i++)
+                if (this->buffer[i] == '\\')
+                    i++;
+            if ((i < end) && (this->buffer[i] == '\n'))
+                currentLine++;
+        }
+        else if ((c == '/') && (i + 1 < end) && (this->buffer[i+1] == '/')) {
+            //Line comments run up to the newline, which is counted next time around
+            while ((i + 1 < end) && (this->buffer[i+1] != '\n'))
+                i++;
+        }
+        else if ((c == '/') && (i + 1 < end) && (this->buffer[i+1] == '*')) {
+            //Block comments run up to the closing */
+            for (i += 2; (i + 1 < end) && !((this->buffer[i] == '*') && (this->buffer[i+1] == '/')); i++)
+                if (this->buffer[i] == '\n')
+                    currentLine++;
+            i++;
+        }
+        else if (c == ';') {
+            end = i;
+            break;
+        }
+    }
+    statement.text = this->buffer + start;
+    statement.length = std::min(end, this->bufferSize) - start;
+    statement.lastLine = std::min(currentLine, (int)this->lineCount);
+    return statement;
+}
+
+std::string JavaReader::readLine(int lineNumber) const {
     return this->readLines(std::pair<int,int>(lineNumber,lineNumber));
 }
 
-std::string JavaReader::readLines(std::pair<int,int> bounds) {
+std::string JavaReader::readLines(std::pair<int,int> bounds) const {
     //Get the start and end of the function from the map
     int boundsStart = bounds.first;
     int boundsEnd = bounds.second;
-    //Reset the stream to the beginning of the file
-    this->fileStream.clear();
-    this->fileStream.seekg(0, fileStream.beg);
     //Keep track of the line number and function body
-    int currentLineNumber = 0;
     std::string line;
     std::string functionBody;
-    while(getline(this->fileStream,line)) {
-        currentLineNumber++;
-        //If the current line is within bounds of function, add it to function body
-        if ((currentLineNumber >= boundsStart) && (currentLineNumber <= boundsEnd))
-            functionBody += Util::trim(line) + "\n";
+    //Only the lines within bounds are read, straight out of the buffer
+    for (int currentLineNumber = std::max(boundsStart, 1); currentLineNumber <= boundsEnd; currentLineNumber++) {
+        if (!this->getRawLine(currentLineNumber, line))
+            break;
+        functionBody += Util::trim(line) + "\n";
     }
     return functionBody;
 }
 
-std::string JavaReader::readFunction(int lineNumber) {
+std::string JavaReader::readFunction(int lineNumber) const {
     //Find the function name at the given line number
-    std::string functionName = readFunctionName(lineNumber);
+    Symbol functionName = this->readFunctionSymbol(lineNumber);
     //Return the body of the given function name
     return this->readFunction(functionName);
 }
     
-std::string JavaReader::readFunction(const std::string& functionName) {
+std::string JavaReader::readFunction(const std::string& functionName) const {
+    return this->readFunction(this->findFunctionSymbol(functionName));
+}
+
+std::string JavaReader::readFunction(Symbol functionName) const {
     //If function name is not in functions, return empty string
-    if (!this->functions.count(functionName))
+    std::pair<int,int> bounds = this->getFunctionBounds(functionName);
+    if (bounds.first == -1)
         return std::string();
-    //Read through the functions for a .exec( and return that
-    for (const std::pair<int,int>& p : this->functions[functionName]) {
-        if (this->readLines(p).find(".exec(") != std::string::npos)
-            return this->readLines(p);
-    }
-    //If not just return the first option
-    return this->readLines(this->functions[functionName][0]);
+    return this->readLines(bounds);
+}
+
+std::string JavaReader::readFunctionName(int lineNumber) const {
+    return Symbols::getName(this->readFunctionSymbol(lineNumber));
 }
 
-std::string JavaReader::readFunctionName(int lineNumber) {
+Symbol JavaReader::readFunctionSymbol(int lineNumber) const {
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    this->indexThrough(lineNumber);
     //Find the function lineNumber is contained in
-    for (auto const& v : this->functions) {
-        //v.first is the function name
-        //v.second is the vector of pairs (start,end)
-        for (auto const& p : v.second)
+    for (Symbol functionName : this->functionOrder) {
+        //Each function has a vector of pairs (start,end)
+        for (auto const& p : this->functions.at(functionName))
             //p.first is the first in the pair
             //p.second is the second in the pair
             if ((lineNumber >= p.first) && (lineNumber <= p.second))
-                return v.first;
+                return functionName;
     }
-    //Otherwise return empty string if there is none
-    return std::string();
+    //Otherwise return empty if there is none
+    return Symbols::Empty;
 }
 
-std::string JavaReader::getClassName() {
+//Whether the line is in a comment, going by the comment markers in its function up to it:
+//a "//" on the line itself, or a "/*" after the last "*/". Markers are found by the
+//structural scan rather than by reading the function back in.
+bool JavaReader::isCommented(int lineNumber) const {
+    int functionStart = this->getFunctionBounds(lineNumber).first;
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    int first = std::max(functionStart, 1);
+    int last = std::min(lineNumber, this->lineCount);
+    if (last < first)
+        return false;
+    if (this->getLineStructure(last).hasLineComment)
+        return true;
+    //The closest line with either marker on it decides
+    for (int currentLine = last; currentLine >= first; currentLine--) {
+        const StructuralIndex::Line& structure = this->getLineStructure(currentLine);
+        if ((structure.lastCommentOpen >= 0) || (structure.lastCommentClose >= 0))
+            return structure.lastCommentOpen > structure.lastCommentClose;
+    }
+    return false;
+}
+
+std::string JavaReader::getClassName() const {
+    //The class name comes before any of the members, so stop as soon as it is found
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    while ((this->indexState == FindingClass) && this->indexNextLine());
     return this->className;
 }
 
-std::vector<std::string> JavaReader::readFunctionNames() {
+std::vector<std::string> JavaReader::readFunctionNames() const {
     std::vector<std::string> functionNames;
-    for (auto const& x : this->functions) {
-        //x.first is function name
-        //x.second is int pair boundary
-        functionNames.push_back(x.first);
-    }
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    while (this->indexNextLine());
+    for (Symbol functionName : this->functionOrder)
+        functionNames.push_back(Symbols::getName(functionName));
     return functionNames;
 }
 
-std::pair<int,int> JavaReader::getFunctionBounds(int lineNumber) {
+std::pair<int,int> JavaReader::getFunctionBounds(int lineNumber) const {
     //Find the function name at the given line number
-    std::string functionName = readFunctionName(lineNumber);
+    Symbol functionName = this->readFunctionSymbol(lineNumber);
     //Return the function bounds
     return this->getFunctionBounds(functionName);
 }
 
-std::pair<int,int> JavaReader::getFunctionBounds(const std::string& functionName) {
-    //If function name is not in functions, return -1
-    if (!this->functions.count(functionName))
+std::pair<int,int> JavaReader::getFunctionBounds(const std::string& functionName) const {
+    return this->getFunctionBounds(this->findFunctionSymbol(functionName));
+}
+
+//Looked up names aren't interned, the table is shared and never shrinks. A name that isn't
+//in it yet hasn't been indexed as a function anywhere, so index until this file adds it,
+//and a name it never adds has no function here
+Symbol JavaReader::findFunctionSymbol(const std::string& functionName) const {
+    Symbol functionSymbol = Symbols::find(functionName);
+    if (functionSymbol != Symbols::Empty)
+        return functionSymbol;
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    size_t functionCount = this->functionOrder.size();
+    while (this->indexNextLine()) {
+        if (this->functionOrder.size() == functionCount)
+            continue;
+        functionCount = this->functionOrder.size();
+        functionSymbol = Symbols::find(functionName);
+        if (functionSymbol != Symbols::Empty)
+            return functionSymbol;
+    }
+    return Symbols::find(functionName);
+}
+
+//The bounds of every method with the name in file order, indexing the whole file to be sure
+std::vector<std::pair<int,int>> JavaReader::getOverloadBounds(const std::string& functionName) const {
+    std::lock_guard<std::mutex> lock(this->indexLock);
+    while (this->indexNextLine());
+    //Every name in the file is interned by now, so a name that isn't has no overloads
+    std::unordered_map<Symbol, std::vector<std::pair<int,int>>>::const_iterator function =
+            this->functions.find(Symbols::find(functionName));
+    if (function == this->functions.end())
+        return std::vector<std::pair<int,int>>();
+    return function->second;
+}
+
+std::pair<int,int> JavaReader::getFunctionBounds(Symbol functionName) const {
+    //No function is ever named empty, so don't index the whole file to find that out
+    if (functionName == Symbols::Empty)
         return std::pair<int,int>(-1,-1);
+    std::lock_guard<std::mutex> lock(this->indexLock);
     //Read through the functions for a .exec( and return that
-    for (const std::pair<int,int>& p : this->functions[functionName]) {
-        if (this->readLines(p).find(".exec(") != std::string::npos)
-            return p;
-    }
+    //Overloads are found in file order, so the first with a .exec( ends the search early
+    size_t checked = 0;
+    do {
+        std::unordered_map<Symbol, std::vector<std::pair<int,int>>>::const_iterator function =
+                this->functions.find(functionName);
+        if (function == this->functions.end())
+            continue;
+        for (; checked < function->second.size(); checked++)
+            if (this->containsExec(function->second[checked]))
+                return function->second[checked];
+    } while (this->indexNextLine());
+    //If function name is not in functions, return -1
+    std::unordered_map<Symbol, std::vector<std::pair<int,int>>>::const_iterator function =
+            this->functions.find(functionName);
+    if (function == this->functions.end())
+        return std::pair<int,int>(-1,-1);
     //If not just return the first option
-    return this->functions[functionName][0];
+    return function->second[0];
 }
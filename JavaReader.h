@@ -34,23 +34,73 @@
 
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ProjectSnapshot.h"
+#include "StructuralIndex.h"
+#include "Symbols.h"
+
+//A statement as it appears in the file, pointing into the reader's buffer
+struct JavaStatement {
+    const char* text;
+    size_t length;
+    int firstLine;
+    int lastLine;
+};
 
 class JavaReader {
 public:
     JavaReader(const std::string& filePath);
-    std::string readLine(int lineNumber);
-    std::string readLines(std::pair<int,int> bounds);
-    std::string readFunction(int lineNumber);
-    std::string readFunction(const std::string& functionName);
-    std::string readFunctionName(int lineNumber);
-    std::string getClassName();
-    std::vector<std::string> readFunctionNames();
-    std::pair<int,int> getFunctionBounds(int lineNumber);
-    std::pair<int,int> getFunctionBounds(const std::string& functionName);
+    JavaReader(const std::string& filePath, std::string& contents);
+    JavaReader(const std::string& filePath, const ProjectSnapshot::File& file);
+    std::string readLine(int lineNumber) const;
+    std::string readLines(std::pair<int,int> bounds) const;
+    std::string readFunction(int lineNumber) const;
+    std::string readFunction(const std::string& functionName) const;
+    std::string readFunction(Symbol functionName) const;
+    std::string readFunctionName(int lineNumber) const;
+    Symbol readFunctionSymbol(int lineNumber) const;
+    std::string getClassName() const;
+    bool isCommented(int lineNumber) const;
+    std::vector<std::string> readFunctionNames() const;
+    std::pair<int,int> getFunctionBounds(int lineNumber) const;
+    std::pair<int,int> getFunctionBounds(const std::string& functionName) const;
+    std::pair<int,int> getFunctionBounds(Symbol functionName) const;
+    std::vector<std::pair<int,int>> getOverloadBounds(const std::string& functionName) const;
+    int getLineCount() const;
+    JavaStatement readStatement(int lineNumber) const;
 private:
-    std::ifstream fileStream;
-    std::string className;
-    std::map<std::string, std::vector<std::pair<int,int>>> functions;
+    //How far the lazy index has read, lookups carry it on from here
+    enum IndexState {FindingClass, OpeningClass, ReadingMembers, Indexed};
+    //The file and its line starts, either owned here or borrowed from a snapshot
+    std::string ownedBuffer;
+    std::vector<int> ownedLineStarts;
+    const char* buffer;
+    size_t bufferSize;
+    const int* lineStarts;
+    int lineCount;
+    mutable std::mutex indexLock;
+    mutable IndexState indexState;
+    mutable int indexedLines;
+    mutable int blockDepth;
+    mutable int internalClassDepth;
+    mutable int functionStart;
+    mutable std::string currentFunctionName;
+    mutable std::string className;
+    mutable std::unordered_map<Symbol, std::vector<std::pair<int,int>>> functions;
+    mutable std::vector<Symbol> functionOrder;
+    mutable std::vector<StructuralIndex::Line> lineStructures;
+    void index();
+    void resetIndex();
+    bool indexNextLine() const;
+    void indexThrough(int lineNumber) const;
+    Symbol findFunctionSymbol(const std::string& functionName) const;
+    bool containsExec(std::pair<int,int> bounds) const;
+    const StructuralIndex::Line& getLineStructure(int lineNumber) const;
+    bool getLineText(int lineNumber, const char*& text, size_t& length) const;
+    bool getRawLine(int lineNumber, std::string& line) const;
 };
 
 #endif /* JAVAREADER_H */
@@ -0,0 +1,248 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   Microbench.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 9:12 AM
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "JavaReader.h"
+#include "StructuralIndex.h"
+#include "Utility.h"
+
+//Every allocation in the process goes through these, including the library's
+//The benchmarks run on one thread so plain counters are enough
+static unsigned long long allocationCount = 0;
+static unsigned long long allocationBytes = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    allocationBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchResult {
+    std::string name;
+    int size;
+    unsigned long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+//Keeps the compiler from throwing away the work being measured
+static volatile size_t sink = 0;
+
+//Run op until minSeconds have passed, doubling the batch each time so the clock is read rarely
+BenchResult runBenchmark(const std::string& name, int size, double minSeconds,
+        const std::function<size_t()>& op) {
+    //One untimed run so first use costs like lazy indexing aren't counted
+    sink += op();
+    unsigned long long iterations = 0;
+    unsigned long long batch = 1;
+    unsigned long long startCount = allocationCount;
+    unsigned long long startBytes = allocationBytes;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < minSeconds) {
+        for (unsigned long long i = 0; i < batch; i++)
+            sink += op();
+        iterations += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    BenchResult result;
+    result.name = name;
+    result.size = size;
+    result.iterations = iterations;
+    result.nsPerOp = elapsed * 1e9 / iterations;
+    result.allocsPerOp = (double)(allocationCount - startCount) / iterations;
+    result.bytesPerOp = (double)(allocationBytes - startBytes) / iterations;
+    return result;
+}
+
+//A line of Java about size characters long, with strings, calls and nesting to walk through
+std::string makeExpression(int size) {
+    std::string piece = "\"cmd /c \" + build(a, b[i], \"x, y\") + (c + d), ";
+    std::string expression = "    ";
+    while (expression.size() < size)
+        expression += piece;
+    expression.resize(size);
+    return expression + "    ";
+}
+
+//A class with enough methods to fill size lines, one runtime exec near the middle
+std::string makeJavaFile(int size) {
+    std::string file = "package bench;\n\npublic class Bench {\n    private String command;\n\n";
+    int lines = 5;
+    for (int method = 0; lines < size; method++) {
+        std::ostringstream body;
+        body << "    public void method" << method << "(String arg) {\n";
+        body << "        String value = arg + \"" << method << "\";\n";
+        if (method == size / 10)
+            body << "        Runtime.getRuntime().exec(value);\n";
+        else
+            body << "        System.out.println(value);\n";
+        body << "    }\n\n";
+        file += body.str();
+        lines += 5;
+    }
+    return file + "}\n";
+}
+
+std::vector<int> parseSizes(const std::string& s) {
+    std::vector<int> sizes;
+    for (const std::string& size : Util::split(s, ","))
+        if (atoi(size.c_str()) > 0)
+            sizes.push_back(atoi(size.c_str()));
+    return sizes;
+}
+
+void writeJson(std::ostream& os, const std::vector<BenchResult>& results) {
+    os << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.nsPerOp
+                << ", \"allocs_per_op\": " << r.allocsPerOp
+                << ", \"bytes_per_op\": " << r.bytesPerOp << "}"
+                << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes = parseSizes("64,512,4096");
+    std::string outputPath = "microbench.json";
+    double minSeconds = 0.2;
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--sizes") && (i + 1 < argc))
+            sizes = parseSizes(argv[++i]);
+        else if (!strcmp(argv[i], "-o") && (i + 1 < argc))
+            outputPath = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && (i + 1 < argc))
+            minSeconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && (i + 1 < argc))
+            filter = argv[++i];
+        else {
+            std::cout << "Usage: microbench [--sizes n,n,...] [--min-time seconds] [--filter name] [-o output.json]" << std::endl;
+            return (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-?")) ? 0 : 1;
+        }
+    }
+    std::vector<BenchResult> results;
+    printf("%-34s %8s %14s %12s %12s\n", "benchmark", "size", "ns/op", "allocs/op", "bytes/op");
+    //For Util the size is characters of input, for JavaReader it is lines of the file
+    for (int size : sizes) {
+        std::string expression = makeExpression(size);
+        std::string javaFile = makeJavaFile(size);
+        //The reader takes over the buffer it's given, so give it a copy
+        std::string readerContents = javaFile;
+        JavaReader javaReader("Bench.java", readerContents);
+        int middle = javaReader.getLineCount() / 2;
+        std::vector<int> lineStarts;
+        StructuralIndex::findLineStarts(javaFile.data(), javaFile.size(), lineStarts);
+        std::vector<std::pair<std::string, std::function<size_t()>>> benchmarks = {
+            {"Util::trim", [&]() { return Util::trim(expression).size(); }},
+            {"Util::split", [&]() { return Util::split(expression, ",").size(); }},
+            {"Util::splitNotAtDepth", [&]() { return Util::splitNotAtDepth(expression, ",").size(); }},
+            {"Util::replaceAtDepth", [&]() { return Util::replaceAtDepth(expression, ",", "\n").size(); }},
+            {"Util::getDepth", [&]() { return (size_t)Util::getDepth(expression, expression.size() - 5); }},
+            {"Util::regexFind", [&]() { return Util::regexFind(expression, "\\.exec\\("); }},
+            {"Util::escapeRegex", [&]() { return Util::escapeRegex(expression).size(); }},
+            {"JavaReader::readLines", [&]() {
+                return javaReader.readLines(std::pair<int,int>(1, javaReader.getLineCount())).size(); }},
+            {"JavaReader::readFunctionName", [&]() { return javaReader.readFunctionName(middle).size(); }},
+            {"JavaReader::index", [&]() {
+                std::string contents = javaFile;
+                return JavaReader("Bench.java", contents).readFunctionNames().size(); }},
+            {"StructuralIndex::scanLines", [&]() {
+                std::vector<StructuralIndex::Line> lines;
+                StructuralIndex::scanLines(javaFile.data(), javaFile.size(), lineStarts.data(),
+                        lineStarts.size(), lineStarts.size(), lines);
+                return lines.size(); }},
+            {"StructuralIndex::scanLines/scalar", [&]() {
+                std::vector<StructuralIndex::Line> lines;
+                StructuralIndex::setVectorized(false);
+                StructuralIndex::scanLines(javaFile.data(), javaFile.size(), lineStarts.data(),
+                        lineStarts.size(), lineStarts.size(), lines);
+                StructuralIndex::setVectorized(true);
+                return lines.size(); }},
+        };
+        for (auto const& benchmark : benchmarks) {
+            if (!filter.empty() && (benchmark.first.find(filter) == std::string::npos))
+                continue;
+            BenchResult result = runBenchmark(benchmark.first, size, minSeconds, benchmark.second);
+            printf("%-34s %8d %14.1f %12.2f %12.1f\n", result.name.c_str(), result.size,
+                    result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+            fflush(stdout);
+            results.push_back(result);
+        }
+    }
+    std::ofstream output(outputPath);
+    if (!output) {
+        std::cerr << "Error: could not write " << outputPath << std::endl;
+        return 1;
+    }
+    writeJson(output, results);
+    std::cout << "Results saved to " << outputPath << std::endl;
+    return 0;
+}
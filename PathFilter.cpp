@@ -0,0 +1,183 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   PathFilter.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 11:40 AM
+ */
+
+#include "PathFilter.h"
+#include <fnmatch.h>
+#include <algorithm>
+#include <fstream>
+#include "Utility.h"
+
+//Split on '/', leaving out the empty and "." segments of paths like "./pkg//Foo.java"
+static std::vector<std::string> splitPath(const std::string& path) {
+    std::vector<std::string> segments;
+    for (const std::string& segment : Util::split(path, "/"))
+        if (!segment.empty() && (segment != "."))
+            segments.push_back(segment);
+    return segments;
+}
+
+PathFilter::Node::Node() : anyChild(-1) {};
+
+//The root of the trie is node 0
+PathFilter::PathFilter() : nodes(1) {};
+
+bool PathFilter::isEmpty() const {
+    return this->rules.empty();
+}
+
+int PathFilter::getRuleCount() const {
+    return this->rules.size();
+}
+
+void PathFilter::addRule(const std::string& pattern, bool exclude) {
+    std::string trimmed = Util::trim(pattern);
+    Rule rule;
+    rule.exclude = exclude;
+    rule.directoryOnly = Util::endsWith(trimmed, "/");
+    if (rule.directoryOnly)
+        trimmed.erase(trimmed.size() - 1);
+    //Only a '/' before the end anchors the pattern to the root, otherwise it can start anywhere
+    bool anchored = (trimmed.find('/') != std::string::npos);
+    std::vector<std::string> segments = splitPath(trimmed);
+    if (segments.empty())
+        return;
+    int node = 0;
+    if (!anchored)
+        node = this->addChild(node, "**");
+    for (const std::string& segment : segments) {
+        //"a/**/**/b" is the same as "a/**/b"
+        if ((segment == "**") && (this->nodes[node].anyChild == node))
+            continue;
+        node = this->addChild(node, segment);
+    }
+    this->nodes[node].rules.push_back(this->rules.size());
+    this->rules.push_back(rule);
+}
+
+//A line of a rule file, blank lines and '#' comments are skipped and '!' includes again
+void PathFilter::addRuleLine(const std::string& line) {
+    std::string trimmed = Util::trim(line);
+    if (!trimmed.empty() && (trimmed[trimmed.size() - 1] == '\r'))
+        trimmed.erase(trimmed.size() - 1);
+    if (trimmed.empty() || (trimmed[0] == '#'))
+        return;
+    if (trimmed[0] == '!')
+        this->addRule(trimmed.substr(1), false);
+    else
+        this->addRule(trimmed, true);
+}
+
+bool PathFilter::addRuleFile(const std::string& filePath) {
+    std::ifstream ruleFile(filePath);
+    if (!ruleFile)
+        return false;
+    std::string line;
+    while (std::getline(ruleFile, line))
+        this->addRuleLine(line);
+    return true;
+}
+
+//Walk the path's segments down the trie, keeping every node a pattern could be at.
+//A rule that matches all the segments matches the file, one that matches only the
+//first few matches a directory the file is in.
+bool PathFilter::isExcluded(const std::string& filePath) const {
+    if (this->rules.empty())
+        return false;
+    std::vector<std::string> segments = splitPath(filePath);
+    std::vector<int> active;
+    this->addClosure(0, active);
+    int lastRule = -1;
+    std::vector<int> next;
+    for (size_t i = 0; (i < segments.size()) && !active.empty(); i++) {
+        next.clear();
+        for (int node : active) {
+            const Node& current = this->nodes[node];
+            //"**" stays where it is, taking up this segment too
+            if (current.anyChild == node)
+                this->addClosure(node, next);
+            std::map<std::string, int>::const_iterator literal = current.literalChildren.find(segments[i]);
+            if (literal != current.literalChildren.end())
+                this->addClosure(literal->second, next);
+            for (const std::pair<std::string, int>& glob : current.globChildren)
+                if (fnmatch(glob.first.c_str(), segments[i].c_str(), 0) == 0)
+                    this->addClosure(glob.second, next);
+        }
+        active.swap(next);
+        bool isFile = (i + 1 == segments.size());
+        for (int node : active)
+            for (int rule : this->nodes[node].rules)
+                if (!(isFile && this->rules[rule].directoryOnly))
+                    lastRule = std::max(lastRule, rule);
+    }
+    return (lastRule >= 0) && this->rules[lastRule].exclude;
+}
+
+int PathFilter::addChild(int node, const std::string& segment) {
+    int child;
+    if (segment == "**") {
+        if (this->nodes[node].anyChild < 0) {
+            //"**" loops on itself, so it gets a node of its own to loop on
+            child = this->nodes.size();
+            this->nodes.push_back(Node());
+            this->nodes[child].anyChild = child;
+            this->nodes[node].anyChild = child;
+        }
+        return this->nodes[node].anyChild;
+    }
+    bool isGlob = (segment.find_first_of("*?[") != std::string::npos);
+    if (!isGlob) {
+        std::map<std::string, int>::const_iterator literal = this->nodes[node].literalChildren.find(segment);
+        if (literal != this->nodes[node].literalChildren.end())
+            return literal->second;
+    }
+    else {
+        for (const std::pair<std::string, int>& glob : this->nodes[node].globChildren)
+            if (glob.first == segment)
+                return glob.second;
+    }
+    child = this->nodes.size();
+    this->nodes.push_back(Node());
+    if (isGlob)
+        this->nodes[node].globChildren.push_back(std::make_pair(segment, child));
+    else
+        this->nodes[node].literalChildren[segment] = child;
+    return child;
+}
+
+//Add a node, and the "**" after it since that can match no segments at all
+void PathFilter::addClosure(int node, std::vector<int>& active) const {
+    while (node >= 0) {
+        if (std::find(active.begin(), active.end(), node) != active.end())
+            return;
+        active.push_back(node);
+        node = (this->nodes[node].anyChild != node) ? this->nodes[node].anyChild : -1;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   PathFilter.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 11:40 AM
+ */
+
+#ifndef PATHFILTER_H
+#define PATHFILTER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+//Include/exclude rules on file paths, in .gitignore syntax, checked before a file is read.
+//A pattern without a '/' matches at any depth, "**" matches any number of directories,
+//a pattern matching a directory covers everything under it, and "!pattern" includes
+//paths again. The last rule to match a path decides, so later rules override earlier ones.
+//Rules are compiled into a trie of path segments shared by all the patterns, so a path is
+//checked in one walk down its segments no matter how many rules there are.
+class PathFilter {
+public:
+    PathFilter();
+    bool isEmpty() const;
+    int getRuleCount() const;
+    void addRule(const std::string& pattern, bool exclude);
+    void addRuleLine(const std::string& line);
+    bool addRuleFile(const std::string& filePath);
+    bool isExcluded(const std::string& filePath) const;
+private:
+    struct Rule {
+        bool exclude;
+        //Patterns ending in '/' only match directories, never the file itself
+        bool directoryOnly;
+    };
+    struct Node {
+        Node();
+        std::map<std::string, int> literalChildren;
+        std::vector<std::pair<std::string, int>> globChildren;
+        //The child for "**", which can take up any number of segments, -1 if none
+        int anyChild;
+        //The rules whose patterns end at this node
+        std::vector<int> rules;
+    };
+    int addChild(int node, const std::string& segment);
+    void addClosure(int node, std::vector<int>& active) const;
+    std::vector<Rule> rules;
+    std::vector<Node> nodes;
+};
+
+#endif /* PATHFILTER_H */
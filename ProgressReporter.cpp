@@ -0,0 +1,178 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ProgressReporter.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 9:41 PM
+ */
+
+#include "ProgressReporter.h"
+#include <csignal>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+//How often the line is redrawn on a terminal, and how often a log line is written otherwise
+static const std::chrono::milliseconds redrawInterval(200);
+static const std::chrono::milliseconds logInterval(10000);
+//How often the reporter looks for a SIGUSR1 between reports
+static const std::chrono::milliseconds signalPollInterval(100);
+
+//Set by the signal handler, the reporter thread does the printing
+static volatile sig_atomic_t snapshotRequested = 0;
+
+static void requestSnapshot(int) {
+    snapshotRequested = 1;
+}
+
+//Print a duration as 1h02m03s, or 2m03s, or 3s
+static std::string formatDuration(double seconds) {
+    long total = (long)(seconds + 0.5);
+    std::ostringstream duration;
+    if (total >= 3600)
+        duration << total / 3600 << "h" << std::setfill('0') << std::setw(2);
+    if (total >= 60)
+        duration << (total / 60) % 60 << "m" << std::setfill('0') << std::setw(2);
+    duration << total % 60 << "s";
+    return duration.str();
+}
+
+//A total of 0 means the number of files isn't known ahead of time
+ProgressReporter::ProgressReporter(long totalFiles) : totalFiles(totalFiles),
+        terminal(isatty(fileno(stdout))), fileCount(0), candidateCount(0),
+        startTime(std::chrono::steady_clock::now()), stopping(false) {};
+
+ProgressReporter::~ProgressReporter() {
+    this->stop();
+}
+
+void ProgressReporter::start() {
+    struct sigaction action = {};
+    action.sa_handler = requestSnapshot;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
+    this->startTime = std::chrono::steady_clock::now();
+    this->reporter = std::thread(&ProgressReporter::reportLoop, this);
+}
+
+//Stop the thread and draw the final counts once more
+void ProgressReporter::stop() {
+    if (!this->reporter.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->stopped.notify_all();
+    this->reporter.join();
+    signal(SIGUSR1, SIG_DFL);
+    if (this->terminal)
+        std::cout << "\r" << this->describe(false) << std::flush;
+    else
+        std::cerr << this->describe(false) << std::endl;
+}
+
+void ProgressReporter::setTotalFiles(long totalFiles) {
+    this->totalFiles = totalFiles;
+}
+
+void ProgressReporter::startFile(const std::string& filePath) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->currentFile = filePath;
+}
+
+void ProgressReporter::finishFile(long candidates) {
+    this->candidateCount += candidates;
+    this->fileCount++;
+}
+
+void ProgressReporter::reportLoop() {
+    std::chrono::milliseconds interval = this->terminal ? redrawInterval : logInterval;
+    std::chrono::steady_clock::time_point nextReport = std::chrono::steady_clock::now() + interval;
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (!this->stopping) {
+        this->stopped.wait_for(guard, signalPollInterval);
+        if (this->stopping)
+            break;
+        //Print outside the lock so the scan loop never waits on the terminal
+        std::string snapshot;
+        std::string report;
+        if (snapshotRequested) {
+            snapshotRequested = 0;
+            guard.unlock();
+            snapshot = this->describe(true);
+            guard.lock();
+        }
+        if (std::chrono::steady_clock::now() >= nextReport) {
+            nextReport += interval;
+            guard.unlock();
+            report = this->describe(false);
+            guard.lock();
+        }
+        guard.unlock();
+        if (!snapshot.empty())
+            std::cerr << snapshot << std::endl;
+        if (!report.empty() && this->terminal)
+            std::cout << "\r" << report << std::flush;
+        else if (!report.empty())
+            std::cerr << report << std::endl;
+        guard.lock();
+    }
+}
+
+//One line of counters and rates, the snapshot adds the file being analyzed
+std::string ProgressReporter::describe(bool snapshot) {
+    long files = this->fileCount;
+    long candidates = this->candidateCount;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->startTime).count();
+    double fileRate = (elapsed > 0) ? files / elapsed : 0;
+    double candidateRate = (elapsed > 0) ? candidates / elapsed : 0;
+    long totalFiles = this->totalFiles;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    line << (snapshot ? "Snapshot: " : "Current Progress: ") << "File " << files;
+    if (totalFiles > 0)
+        line << "/" << totalFiles;
+    line << " | " << fileRate << " files/s | " << candidateRate << " candidates/s";
+    //Without a total there is nothing to estimate against
+    if ((totalFiles > 0) && (fileRate > 0))
+        line << " | ETA " << formatDuration((totalFiles - files) / fileRate);
+    line << " | " << formatDuration(elapsed) << " elapsed";
+    if (snapshot) {
+        line << " | " << candidates << " candidates";
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (!this->currentFile.empty())
+            line << " | at " << this->currentFile;
+    }
+    //Pad so a shorter redraw covers the end of the last one
+    std::string text = line.str();
+    if (this->terminal && !snapshot && (text.length() < 100))
+        text.append(100 - text.length(), ' ');
+    return text;
+}
@@ -0,0 +1,71 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ProgressReporter.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 9:41 PM
+ */
+
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//Reports scan progress from its own thread at a fixed interval, so the scan
+//loop only bumps counters. A terminal gets a line redrawn in place, anything
+//else gets a log line every so often. SIGUSR1 prints the counters right away.
+class ProgressReporter {
+public:
+    ProgressReporter(long totalFiles);
+    ~ProgressReporter();
+    void start();
+    void stop();
+    void setTotalFiles(long totalFiles);
+    void startFile(const std::string& filePath);
+    void finishFile(long candidates);
+private:
+    ProgressReporter(const ProgressReporter&);
+    ProgressReporter& operator=(const ProgressReporter&);
+    void reportLoop();
+    std::string describe(bool snapshot);
+    std::atomic<long> totalFiles;
+    bool terminal;
+    std::atomic<long> fileCount;
+    std::atomic<long> candidateCount;
+    std::string currentFile;
+    std::chrono::steady_clock::time_point startTime;
+    bool stopping;
+    std::thread reporter;
+    std::mutex lock;
+    std::condition_variable stopped;
+};
+
+#endif /* PROGRESSREPORTER_H */
@@ -0,0 +1,266 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ProjectSnapshot.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:05 AM
+ */
+
+#include "ProjectSnapshot.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include "FilePrefetcher.h"
+#include "Utility.h"
+
+static const char snapshotMagic[8] = {'R', 'S', 'S', 'N', 'A', 'P', '0', '1'};
+
+//JavaReader reads the line tables in place as ints
+static_assert(sizeof(int) == sizeof(int32_t), "line tables are stored as 32 bit ints");
+
+//Grep gives paths like "./pkg/Foo.java" or "dir/./pkg/Foo.java", the snapshot stores "pkg/Foo.java"
+static std::string normalizePath(const std::string& filePath) {
+    std::string path;
+    for (const std::string& part : Util::split(filePath, "/")) {
+        if (part.empty() || (part == "."))
+            continue;
+        if (!path.empty())
+            path += "/";
+        path += part;
+    }
+    return path;
+}
+
+//Pad the output up to a multiple of alignment so what follows can be read in place
+static void pad(std::ofstream& output, uint64_t& offset, uint64_t alignment) {
+    while (offset % alignment) {
+        output.put('\0');
+        offset++;
+    }
+}
+
+ProjectSnapshot::ProjectSnapshot(const std::string& snapshotPath) : snapshotPath(snapshotPath),
+        data(NULL), size(0), header(NULL), entries(NULL) {
+    int fd = open(snapshotPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    struct stat status;
+    if ((fstat(fd, &status) == 0) && (status.st_size >= sizeof(Header))) {
+        void* mapped = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            this->data = (const char*)mapped;
+            this->size = status.st_size;
+        }
+    }
+    //The mapping stays good after the descriptor is closed
+    close(fd);
+    if (this->data == NULL)
+        return;
+    this->header = (const Header*)this->data;
+    this->entries = (const Entry*)(this->data + this->header->entriesOffset);
+    if (!this->validate()) {
+        munmap((void*)this->data, this->size);
+        this->data = NULL;
+        this->header = NULL;
+        this->entries = NULL;
+    }
+}
+
+ProjectSnapshot::~ProjectSnapshot() {
+    if (this->data != NULL)
+        munmap((void*)this->data, this->size);
+}
+
+bool ProjectSnapshot::isOpen() const {
+    return (this->data != NULL);
+}
+
+const std::string& ProjectSnapshot::getPath() const {
+    return this->snapshotPath;
+}
+
+int ProjectSnapshot::getFileCount() const {
+    return this->isOpen() ? this->header->fileCount : 0;
+}
+
+std::string ProjectSnapshot::getFilePath(int index) const {
+    const Entry& entry = this->entries[index];
+    return std::string(this->data + entry.pathOffset, entry.pathLength);
+}
+
+//Binary search the entries, which were written in path order
+bool ProjectSnapshot::find(const std::string& filePath, File& file) const {
+    if (!this->isOpen())
+        return false;
+    std::string path = normalizePath(filePath);
+    int low = 0;
+    int high = this->header->fileCount - 1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        int comparison = this->compareFilePath(middle, path);
+        if (comparison < 0)
+            low = middle + 1;
+        else if (comparison > 0)
+            high = middle - 1;
+        else {
+            const Entry& entry = this->entries[middle];
+            file.contents = this->data + entry.contentsOffset;
+            file.length = entry.contentsLength;
+            file.lineStarts = (const int32_t*)(this->data + entry.lineStartsOffset);
+            file.lineCount = entry.lineCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+//Compare like std::string::compare, so the order matches the sort the entries were written in
+int ProjectSnapshot::compareFilePath(int index, const std::string& filePath) const {
+    const Entry& entry = this->entries[index];
+    size_t length = std::min((size_t)entry.pathLength, filePath.size());
+    int comparison = memcmp(this->data + entry.pathOffset, filePath.data(), length);
+    if (comparison != 0)
+        return comparison;
+    if (entry.pathLength == filePath.size())
+        return 0;
+    return (entry.pathLength < filePath.size()) ? -1 : 1;
+}
+
+//Check everything the entries point at is inside the mapping, once, so lookups don't have to
+bool ProjectSnapshot::validate() const {
+    if (memcmp(this->header->magic, snapshotMagic, sizeof(snapshotMagic)) != 0)
+        return false;
+    if (this->header->snapshotSize != this->size)
+        return false;
+    uint64_t entriesSize = (uint64_t)this->header->fileCount * sizeof(Entry);
+    if ((this->header->entriesOffset % alignof(Entry)) || (this->header->entriesOffset > this->size)
+            || (entriesSize > this->size - this->header->entriesOffset))
+        return false;
+    for (uint32_t i = 0; i < this->header->fileCount; i++) {
+        const Entry& entry = this->entries[i];
+        if ((entry.pathOffset > this->size) || (entry.pathLength > this->size - entry.pathOffset))
+            return false;
+        if ((entry.contentsOffset > this->size) || (entry.contentsLength > this->size - entry.contentsOffset))
+            return false;
+        if ((entry.lineStartsOffset % alignof(int32_t)) || (entry.lineStartsOffset > this->size)
+                || ((uint64_t)entry.lineCount * sizeof(int32_t) > this->size - entry.lineStartsOffset))
+            return false;
+        //JavaReader indexes the contents at the line starts directly, so they have to start
+        //at 0 and go up inside the contents, the same as create() writes them
+        const int32_t* lineStarts = (const int32_t*)(this->data + entry.lineStartsOffset);
+        for (uint32_t line = 0; line < entry.lineCount; line++) {
+            if ((lineStarts[line] < 0) || ((uint64_t)lineStarts[line] >= entry.contentsLength))
+                return false;
+            if ((line == 0) ? (lineStarts[line] != 0) : (lineStarts[line] <= lineStarts[line - 1]))
+                return false;
+        }
+    }
+    return true;
+}
+
+//Pack every .java file under the project into a new snapshot
+//It's written next to the destination and renamed over it, so a snapshot being read is never half written
+bool ProjectSnapshot::create(const std::string& projectPath, const std::string& snapshotPath, int& fileCount) {
+    std::vector<std::string> javaFiles;
+    findJavaFiles(projectPath, "", javaFiles);
+    std::sort(javaFiles.begin(), javaFiles.end());
+    fileCount = javaFiles.size();
+    std::string temporaryPath = snapshotPath + ".tmp";
+    std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!output)
+        return false;
+    //The header is written again at the end, once the entries' offset is known
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.fileCount = javaFiles.size();
+    output.write((const char*)&header, sizeof(header));
+    uint64_t offset = sizeof(header);
+    std::vector<Entry> entries;
+    std::vector<int32_t> lineStarts;
+    for (const std::string& filePath : javaFiles) {
+        std::string contents = FilePrefetcher::readFile(projectPath + "/" + filePath);
+        //The same line starts JavaReader would find for itself
+        lineStarts.clear();
+        for (size_t i = 0; i < contents.size(); i++)
+            if ((i == 0) || (contents[i-1] == '\n'))
+                lineStarts.push_back(i);
+        Entry entry;
+        entry.pathOffset = offset;
+        entry.pathLength = filePath.size();
+        output.write(filePath.data(), filePath.size());
+        offset += filePath.size();
+        entry.contentsOffset = offset;
+        entry.contentsLength = contents.size();
+        output.write(contents.data(), contents.size());
+        offset += contents.size();
+        pad(output, offset, alignof(int32_t));
+        entry.lineStartsOffset = offset;
+        entry.lineCount = lineStarts.size();
+        output.write((const char*)lineStarts.data(), lineStarts.size() * sizeof(int32_t));
+        offset += lineStarts.size() * sizeof(int32_t);
+        entries.push_back(entry);
+    }
+    pad(output, offset, alignof(Entry));
+    header.entriesOffset = offset;
+    output.write((const char*)entries.data(), entries.size() * sizeof(Entry));
+    offset += entries.size() * sizeof(Entry);
+    header.snapshotSize = offset;
+    output.seekp(0);
+    output.write((const char*)&header, sizeof(header));
+    output.close();
+    if (!output || (rename(temporaryPath.c_str(), snapshotPath.c_str()) != 0)) {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+//Every .java file under the project, by its path relative to the project
+void ProjectSnapshot::findJavaFiles(const std::string& projectPath, const std::string& relativePath,
+        std::vector<std::string>& javaFiles) {
+    DIR* directory = opendir((projectPath + "/" + relativePath).c_str());
+    if (directory == NULL)
+        return;
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        std::string name = entry->d_name;
+        if ((name == ".") || (name == ".."))
+            continue;
+        std::string entryPath = relativePath.empty() ? name : relativePath + "/" + name;
+        if (entry->d_type == DT_DIR)
+            findJavaFiles(projectPath, entryPath, javaFiles);
+        else if (Util::endsWith(name, ".java"))
+            javaFiles.push_back(entryPath);
+    }
+    closedir(directory);
+}
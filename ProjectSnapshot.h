@@ -0,0 +1,89 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ProjectSnapshot.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:05 AM
+ */
+
+#ifndef PROJECTSNAPSHOT_H
+#define PROJECTSNAPSHOT_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//Every .java file of a project packed into one file, so a scan maps it once
+//instead of opening and reading each file. Each file keeps its path, its contents
+//and the offsets its lines start at, files are looked up by path relative to the root.
+class ProjectSnapshot {
+public:
+    //A file inside the mapped snapshot, only good while the snapshot is open
+    struct File {
+        const char* contents;
+        size_t length;
+        const int32_t* lineStarts;
+        int lineCount;
+    };
+    ProjectSnapshot(const std::string& snapshotPath);
+    ~ProjectSnapshot();
+    bool isOpen() const;
+    const std::string& getPath() const;
+    int getFileCount() const;
+    std::string getFilePath(int index) const;
+    bool find(const std::string& filePath, File& file) const;
+    static bool create(const std::string& projectPath, const std::string& snapshotPath, int& fileCount);
+    static void findJavaFiles(const std::string& projectPath, const std::string& relativePath,
+            std::vector<std::string>& javaFiles);
+private:
+    //Laid out as stored, the header starts the file and the entries end it in path order
+    struct Header {
+        char magic[8];
+        uint32_t fileCount;
+        uint32_t reserved;
+        uint64_t entriesOffset;
+        uint64_t snapshotSize;
+    };
+    struct Entry {
+        uint64_t pathOffset;
+        uint64_t contentsOffset;
+        uint64_t contentsLength;
+        uint64_t lineStartsOffset;
+        uint32_t pathLength;
+        uint32_t lineCount;
+    };
+    ProjectSnapshot(const ProjectSnapshot&);
+    ProjectSnapshot& operator=(const ProjectSnapshot&);
+    bool validate() const;
+    int compareFilePath(int index, const std::string& filePath) const;
+    std::string snapshotPath;
+    const char* data;
+    size_t size;
+    const Header* header;
+    const Entry* entries;
+};
+
+#endif /* PROJECTSNAPSHOT_H */
@@ -0,0 +1,315 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   SampleEstimator.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 1:15 PM
+ */
+
+#include "SampleEstimator.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+#include "Utility.h"
+
+//Two sided 95% confidence from the normal approximation
+static const double confidenceZ = 1.96;
+
+static double measureCandidates(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.candidates;
+}
+
+static double measureRuntime(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.runtime;
+}
+
+static double measureHardcoded(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.hardcoded;
+}
+
+static double measureInput(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.input;
+}
+
+static double measureOther(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.other;
+}
+
+static double measureUnresolved(const SampleEstimator::Observation& observation, Symbol) {
+    return observation.unresolved;
+}
+
+static double measureType(const SampleEstimator::Observation& observation, Symbol type) {
+    std::unordered_map<Symbol, int>::const_iterator count = observation.types.find(type);
+    return (count == observation.types.end()) ? 0 : count->second;
+}
+
+static double measureAllTypes(const SampleEstimator::Observation& observation, Symbol) {
+    double total = 0;
+    for (auto const& count : observation.types)
+        total += count.second;
+    return total;
+}
+
+//"812 +/- 45", or "43.1% +/- 2.9%" for a ratio
+static std::string formatEstimate(double value, double margin, bool percent) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(percent ? 1 : 0);
+    if (percent)
+        text << value * 100 << "% +/- " << margin * 100 << "%";
+    else
+        text << value << " +/- " << margin;
+    return text.str();
+}
+
+SampleEstimator::Observation::Observation() : candidates(0), runtime(0), hardcoded(0), input(0), other(0),
+        unresolved(0) {};
+
+SampleEstimator::Stratum::Stratum() : fileCount(0), candidateCount(0), sampleCount(0) {};
+
+SampleEstimator::SampleEstimator(const std::map<std::string, std::vector<int>>& fileLines,
+        double fraction, int sampleFiles, unsigned long seed) : fileCount(fileLines.size()),
+        candidateCount(0), sampleCandidateCount(0), seed(seed) {
+    //Group the files by their top directory, each group keeps the grep input's path order
+    std::map<std::string, std::vector<std::map<std::string, std::vector<int>>::const_iterator>> members;
+    for (std::map<std::string, std::vector<int>>::const_iterator file = fileLines.begin();
+            file != fileLines.end(); ++file) {
+        members[getStratumName(file->first)].push_back(file);
+        this->candidateCount += file->second.size();
+    }
+    int sampleSize = (sampleFiles > 0) ? sampleFiles : (int)std::ceil(fraction * this->fileCount);
+    sampleSize = std::max(0, std::min(sampleSize, this->fileCount));
+    //Every stratum needs two files sampled for its variance, a sample too small for that
+    //isn't stratified at all
+    int minimumSize = 0;
+    for (auto const& stratum : members)
+        minimumSize += std::min((int)stratum.second.size(), 2);
+    if (sampleSize < minimumSize) {
+        std::vector<std::map<std::string, std::vector<int>>::const_iterator> all;
+        for (auto const& stratum : members)
+            all.insert(all.end(), stratum.second.begin(), stratum.second.end());
+        members.clear();
+        members["(all files)"].swap(all);
+        minimumSize = std::min(this->fileCount, 2);
+    }
+    //Give each stratum its minimum, then share out the rest in proportion to stratum size,
+    //the largest remainders getting the files left over from rounding down
+    std::map<std::string, int> allocation;
+    int allocated = 0;
+    for (auto const& stratum : members) {
+        allocation[stratum.first] = std::min((int)stratum.second.size(), 2);
+        allocated += allocation[stratum.first];
+    }
+    int remaining = sampleSize - allocated;
+    std::vector<std::pair<double, std::string>> remainders;
+    for (auto const& stratum : members) {
+        double share = (double)remaining * stratum.second.size() / this->fileCount;
+        int extra = std::min((int)share, (int)stratum.second.size() - allocation[stratum.first]);
+        allocation[stratum.first] += extra;
+        allocated += extra;
+        remainders.push_back(std::make_pair(share - extra, stratum.first));
+    }
+    std::stable_sort(remainders.begin(), remainders.end(),
+            [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+                return a.first > b.first; });
+    while (allocated < sampleSize) {
+        for (const std::pair<double, std::string>& remainder : remainders) {
+            if (allocated == sampleSize)
+                break;
+            if (allocation[remainder.second] < members[remainder.second].size()) {
+                allocation[remainder.second]++;
+                allocated++;
+            }
+        }
+    }
+    //Pick each stratum's files with a partial Fisher-Yates shuffle. The generator's output
+    //is fixed by the standard, unlike std::shuffle, so a seed picks the same files everywhere.
+    std::mt19937 generator(seed);
+    for (auto& stratum : members) {
+        Stratum& counts = this->strata[stratum.first];
+        counts.fileCount = stratum.second.size();
+        counts.sampleCount = allocation[stratum.first];
+        for (auto const& file : stratum.second)
+            counts.candidateCount += file->second.size();
+        for (int i = 0; i < counts.sampleCount; i++) {
+            int j = i + generator() % (counts.fileCount - i);
+            std::swap(stratum.second[i], stratum.second[j]);
+            this->sample[stratum.second[i]->first] = stratum.second[i]->second;
+            this->sampledStrata[stratum.second[i]->first] = stratum.first;
+            this->sampleCandidateCount += stratum.second[i]->second.size();
+        }
+    }
+}
+
+//The sampled files and their candidate lines, to be scanned like a grep input
+const std::map<std::string, std::vector<int>>& SampleEstimator::getSample() const {
+    return this->sample;
+}
+
+void SampleEstimator::addResult(const FileResult& result) {
+    std::map<std::string, std::string>::const_iterator stratum = this->sampledStrata.find(result.filePath);
+    if (stratum == this->sampledStrata.end())
+        return;
+    //Counted the same way the session counts a file's uses
+    Observation observation;
+    observation.candidates = result.lineCount;
+    for (const CandidateResult& candidate : result.candidates) {
+        if (candidate.category == CandidateResult::NotRuntime)
+            continue;
+        observation.runtime += 1;
+        for (Symbol type : candidate.types)
+            observation.types[type] += 1;
+        if (candidate.category == CandidateResult::Hardcoded)
+            observation.hardcoded += 1;
+        else if (candidate.category == CandidateResult::Input)
+            observation.input += 1;
+        else if (candidate.category == CandidateResult::Unresolved)
+            observation.unresolved += 1;
+        else
+            observation.other += 1;
+    }
+    this->strata[stratum->second].observations.push_back(observation);
+}
+
+//Every file's candidate count is known from the grep input, and uses go along with
+//candidates, so a total is estimated as its ratio to candidates times the known candidates.
+//That leaves out how much files vary in size, which would otherwise swamp the interval.
+SampleEstimator::Estimate SampleEstimator::estimateTotal(Measure measure, Symbol type) const {
+    Estimate estimate = this->estimateRatio(measure, type, measureCandidates, Symbols::Empty);
+    estimate.value *= this->candidateCount;
+    estimate.margin *= this->candidateCount;
+    return estimate;
+}
+
+//Stratified estimate of a total, each stratum's mean scaled up to its number of files.
+//The variance has the finite population correction, so a stratum sampled whole adds none.
+SampleEstimator::Estimate SampleEstimator::expandTotal(Measure measure, Symbol type) const {
+    Estimate estimate = { 0, 0 };
+    double variance = 0;
+    for (auto const& stratum : this->strata) {
+        const std::vector<Observation>& observations = stratum.second.observations;
+        double n = observations.size();
+        double population = stratum.second.fileCount;
+        if (n == 0)
+            continue;
+        double sum = 0;
+        for (const Observation& observation : observations)
+            sum += measure(observation, type);
+        double mean = sum / n;
+        double squares = 0;
+        for (const Observation& observation : observations)
+            squares += (measure(observation, type) - mean) * (measure(observation, type) - mean);
+        estimate.value += population * mean;
+        if (n > 1)
+            variance += population * population * (1 - n / population) * (squares / (n - 1)) / n;
+    }
+    estimate.margin = confidenceZ * std::sqrt(variance);
+    return estimate;
+}
+
+//Ratio of two estimated totals, with its variance from the linearized residuals y - R x
+SampleEstimator::Estimate SampleEstimator::estimateRatio(Measure numerator, Symbol numeratorType,
+        Measure denominator, Symbol denominatorType) const {
+    Estimate estimate = { 0, 0 };
+    double numeratorTotal = this->expandTotal(numerator, numeratorType).value;
+    double denominatorTotal = this->expandTotal(denominator, denominatorType).value;
+    if (denominatorTotal <= 0)
+        return estimate;
+    estimate.value = numeratorTotal / denominatorTotal;
+    double variance = 0;
+    for (auto const& stratum : this->strata) {
+        const std::vector<Observation>& observations = stratum.second.observations;
+        double n = observations.size();
+        double population = stratum.second.fileCount;
+        if (n < 2)
+            continue;
+        std::vector<double> residuals;
+        double mean = 0;
+        for (const Observation& observation : observations) {
+            residuals.push_back(numerator(observation, numeratorType) -
+                    estimate.value * denominator(observation, denominatorType));
+            mean += residuals.back() / n;
+        }
+        double squares = 0;
+        for (double residual : residuals)
+            squares += (residual - mean) * (residual - mean);
+        variance += population * population * (1 - n / population) * (squares / (n - 1)) / n;
+    }
+    estimate.margin = confidenceZ * std::sqrt(variance) / denominatorTotal;
+    return estimate;
+}
+
+void SampleEstimator::writeReport(std::ostream& output) const {
+    output << "Sampled " << this->sample.size() << " of " << this->fileCount << " files (";
+    output << this->sampleCandidateCount << " of " << this->candidateCount << " candidates) from ";
+    output << this->strata.size() << " strata, seed " << this->seed << std::endl;
+    output << "Estimated for all files, with 95% confidence intervals:" << std::endl;
+    Estimate uses = this->estimateTotal(measureRuntime, Symbols::Empty);
+    output << "  Uses: " << formatEstimate(uses.value, uses.margin, false) << std::endl;
+    const char* names[] = { "Hardcoded", "From function input", "Other", "Unresolved (budget)" };
+    Measure measures[] = { measureHardcoded, measureInput, measureOther, measureUnresolved };
+    for (int i = 0; i < 4; i++) {
+        Estimate total = this->estimateTotal(measures[i], Symbols::Empty);
+        //Only say anything about budgets when some were used up
+        if ((measures[i] == measureUnresolved) && (total.value == 0))
+            continue;
+        Estimate share = this->estimateRatio(measures[i], Symbols::Empty, measureRuntime, Symbols::Empty);
+        output << "  " << names[i] << ": " << formatEstimate(total.value, total.margin, false);
+        output << " (" << formatEstimate(share.value, share.margin, true) << " of uses)" << std::endl;
+    }
+    //The type table gives each type's uses and its share of all the argument types
+    output << "\nEstimated Exec Input Table\n" << std::endl;
+    output << std::left << std::setw(20) << "Variable Type" << std::right << " | ";
+    output << std::left << std::setw(16) << "Uses" << std::right << " | ";
+    output << "Share" << std::endl;
+    output << std::string(56, '-') << std::endl;
+    std::set<Symbol> typeSet;
+    for (auto const& stratum : this->strata)
+        for (const Observation& observation : stratum.second.observations)
+            for (auto const& count : observation.types)
+                typeSet.insert(count.first);
+    std::vector<Symbol> types(typeSet.begin(), typeSet.end());
+    std::sort(types.begin(), types.end(), Symbols::lessByName);
+    for (Symbol type : types) {
+        Estimate total = this->estimateTotal(measureType, type);
+        Estimate share = this->estimateRatio(measureType, type, measureAllTypes, Symbols::Empty);
+        output << std::left << std::setw(20) << Symbols::getName(type) << std::right << " | ";
+        output << std::left << std::setw(16) << formatEstimate(total.value, total.margin, false) << std::right << " | ";
+        output << formatEstimate(share.value, share.margin, true) << std::endl;
+    }
+}
+
+//Strata are the top directory of the path, files at the top are a stratum of their own
+std::string SampleEstimator::getStratumName(const std::string& filePath) {
+    std::vector<std::string> segments;
+    for (const std::string& segment : Util::split(filePath, "/"))
+        if (!segment.empty() && (segment != "."))
+            segments.push_back(segment);
+    return (segments.size() > 1) ? segments[0] : "(top)";
+}
@@ -0,0 +1,93 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   SampleEstimator.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 1:15 PM
+ */
+
+#ifndef SAMPLEESTIMATOR_H
+#define SAMPLEESTIMATOR_H
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ScanSession.h"
+#include "Symbols.h"
+
+//Estimates a whole scan's totals from a random sample of its files.
+//Files are grouped into strata by their top directory and each stratum is sampled
+//in proportion to its size, so big and small parts of the tree are both represented.
+//Totals are estimated stratum by stratum, with 95% confidence intervals.
+class SampleEstimator {
+public:
+    //The uses found in one sampled file
+    struct Observation {
+        Observation();
+        double candidates;
+        double runtime;
+        double hardcoded;
+        double input;
+        double other;
+        double unresolved;
+        std::unordered_map<Symbol, int> types;
+    };
+    SampleEstimator(const std::map<std::string, std::vector<int>>& fileLines, double fraction,
+            int sampleFiles, unsigned long seed);
+    const std::map<std::string, std::vector<int>>& getSample() const;
+    void addResult(const FileResult& result);
+    void writeReport(std::ostream& output) const;
+private:
+    struct Stratum {
+        Stratum();
+        int fileCount;
+        int candidateCount;
+        int sampleCount;
+        std::vector<Observation> observations;
+    };
+    //An estimated total or ratio and the half width of its 95% interval
+    struct Estimate {
+        double value;
+        double margin;
+    };
+    typedef double (*Measure)(const Observation& observation, Symbol type);
+    Estimate estimateTotal(Measure measure, Symbol type) const;
+    Estimate expandTotal(Measure measure, Symbol type) const;
+    Estimate estimateRatio(Measure numerator, Symbol numeratorType, Measure denominator,
+            Symbol denominatorType) const;
+    static std::string getStratumName(const std::string& filePath);
+    std::map<std::string, Stratum> strata;
+    std::map<std::string, std::string> sampledStrata;
+    std::map<std::string, std::vector<int>> sample;
+    int fileCount;
+    int candidateCount;
+    int sampleCandidateCount;
+    unsigned long seed;
+};
+
+#endif /* SAMPLEESTIMATOR_H */
@@ -0,0 +1,329 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ScanCheckpoint.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 19, 2026, 1:37 AM
+ */
+
+#include "ScanCheckpoint.h"
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+
+static const char checkpointMagic[8] = { 'R', 'S', 'C', 'H', 'K', 'P', '0', '3' };
+
+//Records are written out at least this often, a stopped scan loses no more than that
+static const double checkpointSeconds = 10.0;
+
+namespace {
+    //FNV-1a, enough to tell a record that was cut off or garbled
+    uint32_t checksum(const char* data, size_t length) {
+        uint32_t hash = 2166136261U;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= (unsigned char)data[i];
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+    
+    template <typename T>
+    void writeValue(std::string& output, T value) {
+        output.append((const char*)&value, sizeof(value));
+    }
+    
+    void writeString(std::string& output, const std::string& value) {
+        writeValue<uint32_t>(output, value.size());
+        output.append(value);
+    }
+    
+    //Reads values back in the order they were written, failing past the end
+    struct RecordReader {
+        const char* data;
+        size_t length;
+        size_t position;
+        template <typename T>
+        bool readValue(T& value) {
+            if (this->length - this->position < sizeof(value))
+                return false;
+            memcpy(&value, this->data + this->position, sizeof(value));
+            this->position += sizeof(value);
+            return true;
+        }
+        bool readString(std::string& value) {
+            uint32_t size;
+            if (!this->readValue(size) || (this->length - this->position < size))
+                return false;
+            value.assign(this->data + this->position, size);
+            this->position += size;
+            return true;
+        }
+    };
+    
+    enum EntryFlags { IsTest = 1, Skipped = 2, Excluded = 4, BudgetExhausted = 8, Reused = 16 };
+    
+    void writeEntry(std::string& output, const std::string& projectPath, const ScanCheckpoint::Entry& entry) {
+        const FileResult& result = entry.result;
+        writeString(output, projectPath);
+        writeString(output, result.filePath);
+        writeValue<uint64_t>(output, entry.linesHash);
+        writeValue<uint8_t>(output, (result.isTest ? IsTest : 0) | (result.skipped ? Skipped : 0) |
+                (result.excluded ? Excluded : 0) | (result.budgetExhausted ? BudgetExhausted : 0) |
+                (entry.reused ? Reused : 0));
+        writeValue<int32_t>(output, result.lineCount);
+        writeValue<int64_t>(output, entry.functionContexts);
+        writeValue<int64_t>(output, entry.sharedContexts);
+        writeValue<int64_t>(output, entry.filterLookups);
+        writeValue<int64_t>(output, entry.filterRejections);
+        writeValue<uint32_t>(output, result.candidates.size());
+        for (const CandidateResult& candidate : result.candidates) {
+            writeValue<uint8_t>(output, candidate.category);
+            writeValue<int32_t>(output, candidate.lineNumber);
+            writeString(output, candidate.statement);
+            //Types by name, symbols are only good for the process that interned them
+            writeValue<uint32_t>(output, candidate.types.size());
+            for (size_t i = 0; i < candidate.types.size(); i++) {
+                writeString(output, Symbols::getName(candidate.types[i]));
+                writeValue<uint8_t>(output, candidate.typeHardcoded[i]);
+                writeValue<uint8_t>(output, candidate.typeInput[i]);
+            }
+        }
+    }
+    
+    bool readEntry(RecordReader& reader, std::string& projectPath, ScanCheckpoint::Entry& entry) {
+        FileResult& result = entry.result;
+        uint8_t flags;
+        int32_t lineCount;
+        int64_t functionContexts;
+        int64_t sharedContexts;
+        int64_t filterLookups;
+        int64_t filterRejections;
+        uint32_t candidateCount;
+        if (!reader.readString(projectPath) || !reader.readString(result.filePath) ||
+                !reader.readValue(entry.linesHash) || !reader.readValue(flags) || !reader.readValue(lineCount) ||
+                !reader.readValue(functionContexts) || !reader.readValue(sharedContexts) ||
+                !reader.readValue(filterLookups) || !reader.readValue(filterRejections) ||
+                !reader.readValue(candidateCount))
+            return false;
+        result.isTest = flags & IsTest;
+        result.skipped = flags & Skipped;
+        result.excluded = flags & Excluded;
+        result.budgetExhausted = flags & BudgetExhausted;
+        entry.reused = flags & Reused;
+        result.lineCount = lineCount;
+        entry.functionContexts = functionContexts;
+        entry.sharedContexts = sharedContexts;
+        entry.filterLookups = filterLookups;
+        entry.filterRejections = filterRejections;
+        result.candidates.clear();
+        for (uint32_t i = 0; i < candidateCount; i++) {
+            result.candidates.push_back(CandidateResult());
+            CandidateResult& candidate = result.candidates.back();
+            uint8_t category;
+            int32_t lineNumber;
+            uint32_t typeCount;
+            if (!reader.readValue(category) || (category > CandidateResult::Unresolved) ||
+                    !reader.readValue(lineNumber) || !reader.readString(candidate.statement) ||
+                    !reader.readValue(typeCount))
+                return false;
+            candidate.category = (CandidateResult::Category)category;
+            candidate.lineNumber = lineNumber;
+            for (uint32_t j = 0; j < typeCount; j++) {
+                std::string typeName;
+                uint8_t hardcoded;
+                uint8_t input;
+                if (!reader.readString(typeName) || !reader.readValue(hardcoded) || !reader.readValue(input))
+                    return false;
+                candidate.types.push_back(Symbols::intern(typeName));
+                candidate.typeHardcoded.push_back(hardcoded);
+                candidate.typeInput.push_back(input);
+            }
+        }
+        return true;
+    }
+}
+
+ScanCheckpoint::ScanCheckpoint() : fd(-1), writeFailed(false), lastWrite(std::chrono::steady_clock::now()), resumedCount(0) {};
+
+ScanCheckpoint::~ScanCheckpoint() {
+    this->flush();
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+//Start a checkpoint, or with resume load the one there and carry on appending to it.
+//The signature describes the options of the scan, a checkpoint is only resumed by the same.
+bool ScanCheckpoint::open(const std::string& checkpointPath, const std::string& signature, bool resume,
+        std::string& error) {
+    this->checkpointPath = checkpointPath;
+    this->fd = ::open(checkpointPath.c_str(), O_RDWR | O_CREAT | (resume ? 0 : O_TRUNC), 0644);
+    if (this->fd < 0) {
+        error = "could not open checkpoint " + checkpointPath;
+        return false;
+    }
+    if (resume && !this->load(signature, error))
+        return false;
+    //A new checkpoint starts with its header, a resumed one goes on after its last good record
+    if (lseek(this->fd, 0, SEEK_END) == 0) {
+        this->pending.append(checkpointMagic, sizeof(checkpointMagic));
+        writeString(this->pending, signature);
+        if (!this->writePending()) {
+            error = "could not write checkpoint " + checkpointPath;
+            return false;
+        }
+    }
+    return true;
+}
+
+//Read the records of the checkpoint in, cutting it back to the last one that was whole
+bool ScanCheckpoint::load(const std::string& signature, std::string& error) {
+    std::string contents;
+    char block[65536];
+    ssize_t count;
+    while ((count = read(this->fd, block, sizeof(block))) > 0)
+        contents.append(block, count);
+    //Nothing to resume, it'll be started like a new one
+    if (contents.empty())
+        return true;
+    RecordReader reader = { contents.data(), contents.size(), 0 };
+    std::string recordedSignature;
+    if ((contents.size() < sizeof(checkpointMagic)) ||
+            memcmp(contents.data(), checkpointMagic, sizeof(checkpointMagic))) {
+        error = "not a checkpoint file";
+        return false;
+    }
+    reader.position = sizeof(checkpointMagic);
+    if (!reader.readString(recordedSignature) || (recordedSignature != signature)) {
+        error = "the checkpoint was made by a scan with different options";
+        return false;
+    }
+    size_t validLength = reader.position;
+    while (true) {
+        uint32_t length;
+        uint32_t sum;
+        if (!reader.readValue(length) || !reader.readValue(sum) || (reader.length - reader.position < length) ||
+                (checksum(reader.data + reader.position, length) != sum))
+            break;
+        RecordReader record = { reader.data + reader.position, length, 0 };
+        std::string projectPath;
+        Entry entry;
+        if (!readEntry(record, projectPath, entry))
+            break;
+        std::pair<std::string, std::string> key(projectPath, entry.result.filePath);
+        std::swap(this->entries[key], entry);
+        reader.position += length;
+        validLength = reader.position;
+    }
+    if (ftruncate(this->fd, validLength) != 0) {
+        error = "could not truncate checkpoint";
+        return false;
+    }
+    return true;
+}
+
+//A file recorded with other candidate lines comes from a different grep, so it's analyzed again
+bool ScanCheckpoint::contains(const std::string& projectPath, const std::string& filePath,
+        const std::vector<int>& lineNumbers) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::map<std::pair<std::string, std::string>, Entry>::const_iterator found =
+            this->entries.find(std::make_pair(projectPath, filePath));
+    return (found != this->entries.end()) && (found->second.linesHash == hashLines(lineNumbers));
+}
+
+//Hand over a file's recorded result, each is only counted once
+bool ScanCheckpoint::take(const std::string& projectPath, const std::string& filePath,
+        const std::vector<int>& lineNumbers, Entry& entry) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::map<std::pair<std::string, std::string>, Entry>::iterator found =
+            this->entries.find(std::make_pair(projectPath, filePath));
+    if ((found == this->entries.end()) || (found->second.linesHash != hashLines(lineNumbers)))
+        return false;
+    std::swap(entry, found->second);
+    this->entries.erase(found);
+    this->resumedCount += 1;
+    return true;
+}
+
+//Add a finished file, it's written out with the others once enough time has gone by
+void ScanCheckpoint::record(const std::string& projectPath, const Entry& entry) {
+    std::string payload;
+    writeEntry(payload, projectPath, entry);
+    std::lock_guard<std::mutex> guard(this->lock);
+    writeValue<uint32_t>(this->pending, payload.size());
+    writeValue<uint32_t>(this->pending, checksum(payload.data(), payload.size()));
+    this->pending.append(payload);
+    if ((std::chrono::duration<double>(std::chrono::steady_clock::now() - this->lastWrite).count()
+            >= checkpointSeconds) && !this->writePending() && !this->writeFailed) {
+        std::cerr << "Error: could not write checkpoint " << this->checkpointPath
+                << ", will try again with the next files\n";
+        this->writeFailed = true;
+    }
+}
+
+bool ScanCheckpoint::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->writePending();
+}
+
+size_t ScanCheckpoint::getResumedCount() const {
+    return this->resumedCount;
+}
+
+//FNV-1a over the line numbers in their order, with their count
+uint64_t ScanCheckpoint::hashLines(const std::vector<int>& lineNumbers) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(lineNumbers.size());
+    for (int lineNumber : lineNumbers)
+        add(lineNumber);
+    return hash;
+}
+
+//Append the waiting records and make sure they're on disk before going on. What was
+//written before a failure is dropped from the pending records so it isn't written twice.
+bool ScanCheckpoint::writePending() {
+    this->lastWrite = std::chrono::steady_clock::now();
+    if ((this->fd < 0) || this->pending.empty())
+        return true;
+    size_t written = 0;
+    while (written < this->pending.size()) {
+        ssize_t count = write(this->fd, this->pending.data() + written, this->pending.size() - written);
+        if (count <= 0) {
+            this->pending.erase(0, written);
+            return false;
+        }
+        written += count;
+    }
+    this->pending.clear();
+    return fdatasync(this->fd) == 0;
+}
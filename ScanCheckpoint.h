@@ -0,0 +1,92 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ScanCheckpoint.h
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 1:37 AM
+ */
+
+#ifndef SCANCHECKPOINT_H
+#define SCANCHECKPOINT_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include "ScanSession.h"
+
+//Keeps the results of finished files in a file as the scan goes, so a scan that was
+//stopped can be resumed without analyzing them again. Each file is appended as a
+//record with its length and checksum, written out every few seconds. A record cut off
+//by the process being stopped fails its checksum and is dropped with anything after it.
+//A resumed session counts the recorded results in place of analyzing the files, in the
+//same order, so its report is the same as one from an uninterrupted scan. A file is only
+//resumed if it's asked about the same candidate lines it was recorded with.
+class ScanCheckpoint {
+public:
+    //A finished file's result, the hash of the lines it was given and what analyzing it
+    //added to the statistics
+    struct Entry {
+        FileResult result;
+        uint64_t linesHash;
+        long functionContexts;
+        long sharedContexts;
+        bool reused;
+        long filterLookups;
+        long filterRejections;
+    };
+    ScanCheckpoint();
+    ~ScanCheckpoint();
+    bool open(const std::string& checkpointPath, const std::string& signature, bool resume, std::string& error);
+    bool contains(const std::string& projectPath, const std::string& filePath, const std::vector<int>& lineNumbers);
+    bool take(const std::string& projectPath, const std::string& filePath, const std::vector<int>& lineNumbers,
+            Entry& entry);
+    void record(const std::string& projectPath, const Entry& entry);
+    bool flush();
+    size_t getResumedCount() const;
+    static uint64_t hashLines(const std::vector<int>& lineNumbers);
+private:
+    ScanCheckpoint(const ScanCheckpoint&);
+    ScanCheckpoint& operator=(const ScanCheckpoint&);
+    bool load(const std::string& signature, std::string& error);
+    bool writePending();
+    std::string checkpointPath;
+    int fd;
+    //Set once a write has failed and been reported, the records stay pending for the next try
+    bool writeFailed;
+    std::mutex lock;
+    //Records waiting to be written, and when they last were
+    std::string pending;
+    std::chrono::steady_clock::time_point lastWrite;
+    //Results loaded to resume from, by project path and file path
+    std::map<std::pair<std::string, std::string>, Entry> entries;
+    size_t resumedCount;
+};
+
+#endif /* SCANCHECKPOINT_H */
@@ -0,0 +1,1139 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ScanSession.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 9:58 PM
+ */
+
+#include "ScanSession.h"
+#include "ScanCheckpoint.h"
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <map>
+#include <thread>
+#include "Utility.h"
+#include "WorkBudget.h"
+
+//Peak resident set size of the process in kilobytes
+static long getPeakMemory() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss;
+}
+
+//Files with at least this many candidates are split up between the threads
+static const int parallelCandidateThreshold = 8;
+
+//A file's candidates that sit in the same function, classified against one context
+struct FunctionGroup {
+    std::string functionName;
+    //Indexes into the file's line numbers
+    std::vector<int> candidates;
+};
+
+static CandidateResult analyzeCandidate(JavaParser& jp, int lineNo, const std::string& functionName) {
+    CandidateResult result;
+    result.category = CandidateResult::NotRuntime;
+    result.lineNumber = lineNo;
+    //Get the full line up to the semicolon
+    std::string statement = jp.getFullStatement(lineNo);
+    //Check if the line explicitly calls Runtime.getRuntim().exec()
+    bool hasRuntime = (statement.find("Runtime.getRuntime().exec(") != std::string::npos);
+    bool hasProcess = false;
+    bool processUnknown = false;
+    //Otherwise we want to see if .exec( returns a Process
+    //Use a regex to see if there is an assignment on the left side
+    int nameStart = Util::regexFind(statement, "\\w+ *= *.*\\.exec\\(");
+    //Lines that can't be runtime and commented out lines are told apart without
+    //the budget, so they stay NotRuntime even once it has run out
+    if (!hasRuntime && (nameStart == std::string::npos))
+        return result;
+    if (jp.isCommented(lineNo))
+        return result;
+    //If the search was successful
+    if (nameStart != std::string::npos) {
+        //Find the end of the name being a space or an equals sign
+        int nameEnd = Util::regexFind(statement, "( |=)", nameStart);
+        //If there's no end then that's pretty weird
+        if (nameEnd != std::string::npos) {
+            //Get the name of the lvalue and check if its type is "Process"
+            std::string name = statement.substr(nameStart, nameEnd - nameStart);
+            Symbol type = jp.findType(name, functionName);
+            hasProcess = (type == Symbols::Process);
+            processUnknown = (type == Symbols::Empty);
+        }   
+    }
+    //Ran out before we could even tell whether it's a Process, a line whose lvalue
+    //was found to be something else isn't runtime whatever the budget says
+    if (jp.isOverBudget() && (hasRuntime || processUnknown)) {
+        result.category = CandidateResult::Unresolved;
+        result.statement = statement;
+        return result;
+    }
+    //If neither is true, continue to the next candidate
+    if (!hasRuntime && !hasProcess)
+        return result;
+    //Set initial values for hardcoded and input, we'll look for opposite
+    bool hardcoded = true;
+    bool hasInput = false;
+    //Iterate through all of the inputs to .exec()
+    for (const ExpressionNode* leaf : jp.parseRecursively("exec", lineNo)) {
+        //Get the type of the leaf in the function, these are the types that go into the totals
+        Symbol type = jp.findType(leaf, functionName, true);
+        //If type is missing, it might be a class member
+        if (type == Symbols::Empty) {
+            type = jp.findMemberType(leaf->getText(), true);
+        }
+        result.types.push_back(type);
+        //If jp is not hardcoded, then the whole line isn't
+        bool isHardcoded = jp.isHardcoded(leaf, functionName);
+        if (!isHardcoded)
+            hardcoded = false;
+        result.typeHardcoded.push_back(isHardcoded);
+        //If the leaf is an input to the function surrounding .exec(
+        bool isInput = jp.isInput(leaf, functionName);
+        if (isInput)
+            hasInput = true;
+        result.typeInput.push_back(isInput);
+    }
+    //Answers given after the budget ran out can't be trusted, so leave it unresolved
+    if (jp.isOverBudget()) {
+        result.category = CandidateResult::Unresolved;
+        result.types.clear();
+        result.typeHardcoded.clear();
+        result.typeInput.clear();
+    }
+    //Keep track of how many functions have input and how many are hardcoded
+    else if (hasInput)
+        result.category = CandidateResult::Input;
+    else if (hardcoded)
+        result.category = CandidateResult::Hardcoded;
+    else
+        result.category = CandidateResult::Other;
+    result.statement = statement;
+    return result;
+}
+
+//Group a file's candidates by enclosing function, in the order the functions first appear
+static std::vector<FunctionGroup> groupByFunction(JavaParser& jp, const std::vector<int>& lineNumbers) {
+    std::vector<FunctionGroup> groups;
+    std::map<std::string, size_t> groupIndexes;
+    for (int i = 0; i < lineNumbers.size(); i++) {
+        std::string functionName = jp.getFunctionName(lineNumbers[i]);
+        std::map<std::string, size_t>::const_iterator found = groupIndexes.find(functionName);
+        if (found == groupIndexes.end()) {
+            found = groupIndexes.insert(std::make_pair(functionName, groups.size())).first;
+            groups.push_back(FunctionGroup());
+            groups.back().functionName = functionName;
+        }
+        groups[found->second].candidates.push_back(i);
+    }
+    return groups;
+}
+
+//Prepare the function once, then classify all of its candidates against it
+//Each candidate starts with a full budget, the file's budget runs down across all of them
+//With a profiler each candidate's calls are timed, the shared preparation isn't charged to any
+static void analyzeGroup(JavaParser& jp, const std::vector<int>& lineNumbers, const FunctionGroup& group,
+        std::vector<CandidateResult>& results, const BudgetLimits& limits, WorkBudget& fileBudget,
+        CandidateProfiler* profiler, const std::string& filePath) {
+    WorkBudget candidateBudget(limits.candidateSteps, limits.candidateSeconds);
+    jp.setBudgets(&candidateBudget, &fileBudget);
+    jp.prepareFunction(group.functionName);
+    for (int i : group.candidates) {
+        candidateBudget.start();
+        if (profiler != NULL)
+            profiler->beginCandidate(filePath, lineNumbers[i]);
+        results[i] = analyzeCandidate(jp, lineNumbers[i], group.functionName);
+        if (profiler != NULL)
+            profiler->endCandidate();
+    }
+    jp.setBudgets(NULL, NULL);
+}
+
+//Split groups with more than their share of the file's candidates into slices, so one
+//method with hundreds of hits still spreads over every thread. Each slice prepares its
+//function once, a few repeats of the preparation are cheap next to serial candidates
+static std::vector<FunctionGroup> sliceGroups(const std::vector<FunctionGroup>& groups,
+        size_t candidateCount, int jobs) {
+    size_t sliceSize = std::max<size_t>(1, (candidateCount + jobs - 1) / jobs);
+    std::vector<FunctionGroup> slices;
+    for (const FunctionGroup& group : groups) {
+        for (size_t start = 0; start < group.candidates.size(); start += sliceSize) {
+            size_t end = std::min(group.candidates.size(), start + sliceSize);
+            slices.push_back(FunctionGroup());
+            slices.back().functionName = group.functionName;
+            slices.back().candidates.assign(group.candidates.begin() + start, group.candidates.begin() + end);
+        }
+    }
+    return slices;
+}
+
+//Analyze one file's function groups on several threads, each with its own JavaParser
+//over the shared index, writing each result to the candidate's own slot
+static void analyzeParallel(JavaParser& jp, const std::vector<int>& lineNumbers,
+        const std::vector<FunctionGroup>& groups, std::vector<CandidateResult>& results, int jobs,
+        const BudgetLimits& limits, WorkBudget& fileBudget, CandidateProfiler* profiler,
+        const std::string& filePath) {
+    std::vector<FunctionGroup> slices = sliceGroups(groups, lineNumbers.size(), jobs);
+    std::atomic<size_t> nextSlice(0);
+    std::shared_ptr<JavaFileIndex> fileIndex = jp.getFileIndex();
+    auto work = [&](JavaParser& context) {
+        size_t i;
+        while ((i = nextSlice++) < slices.size())
+            analyzeGroup(context, lineNumbers, slices[i], results, limits, fileBudget, profiler, filePath);
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < std::min<size_t>(jobs, slices.size()); i++)
+        threads.push_back(std::thread([&]() {
+            JavaParser context(fileIndex);
+            work(context);
+        }));
+    work(jp);
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+ScanOptions::ScanOptions() : projectPath("./"), skipTest(false), maxMemory(0),
+        prefetchDepth(8), jobs(1), cachedFiles(0), limits(BudgetLimits()) {};
+
+ScanTotals::ScanTotals() : fileCount(0), testFileCount(0), candidateCount(0), runtimeCount(0),
+        hardcodedCount(0), inputCount(0), unresolvedCount(0), fileBudgetCount(0),
+        functionContextCount(0), sharedContextCount(0), reusedFileCount(0), skippedTestCount(0),
+        excludedFileCount(0), excludedCandidateCount(0), snapshotMissCount(0), snapshotMissCandidateCount(0),
+        makespanSeconds(0), workSeconds(0),
+        longestFileSeconds(0), filterLookupCount(0), filterRejectionCount(0) {};
+
+bool ContentCache::Key::operator<(const Key& other) const {
+    if (this->hash != other.hash)
+        return this->hash < other.hash;
+    if (this->check != other.check)
+        return this->check < other.check;
+    if (this->size != other.size)
+        return this->size < other.size;
+    return this->lineNumbers < other.lineNumbers;
+}
+
+ContentCache::ContentCache() : lookupCount(0), hitCount(0) {};
+
+//Two unrelated 64 bit hashes and the size, so a collision would need all three to match
+ContentCache::Key ContentCache::makeKey(const std::string& contents, const std::vector<int>& lineNumbers) {
+    Key key;
+    //FNV-1a
+    key.hash = 14695981039346656037ULL;
+    for (char c : contents) {
+        key.hash ^= (unsigned char)c;
+        key.hash *= 1099511628211ULL;
+    }
+    key.check = std::hash<std::string>()(contents);
+    key.size = contents.size();
+    key.lineNumbers = lineNumbers;
+    return key;
+}
+
+bool ContentCache::find(const Key& key, std::vector<CandidateResult>& candidates) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->lookupCount++;
+    std::map<Key, std::vector<CandidateResult>>::const_iterator entry = this->entries.find(key);
+    if (entry == this->entries.end())
+        return false;
+    this->hitCount++;
+    candidates = entry->second;
+    return true;
+}
+
+void ContentCache::insert(const Key& key, const std::vector<CandidateResult>& candidates) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->entries[key] = candidates;
+}
+
+long ContentCache::getLookupCount() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->lookupCount;
+}
+
+long ContentCache::getHitCount() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->hitCount;
+}
+
+ScanSession::ScanSession(const ScanOptions& options) : options(options),
+        scheduler(new FileScheduler()), scanStart(time(NULL)), prefetcher(options.prefetchDepth) {
+    //Split the memory budget between the lists of uses, few should be unresolved
+    this->hardcodedUses.setMemoryLimit(options.maxMemory / 4);
+    this->inputUses.setMemoryLimit(options.maxMemory / 4);
+    this->otherUses.setMemoryLimit(options.maxMemory / 4);
+    this->unresolvedUses.setMemoryLimit(options.maxMemory / 16);
+}
+
+const ScanOptions& ScanSession::getOptions() const {
+    return this->options;
+}
+
+//Share analyzed results with other sessions, by file content
+void ScanSession::setContentCache(const std::shared_ptr<ContentCache>& contentCache) {
+    this->contentCache = contentCache;
+}
+
+//Read files out of a snapshot instead of the project directory, nothing is read ahead then
+//The snapshot has to be set before anything is queued
+void ScanSession::setSnapshot(const std::shared_ptr<ProjectSnapshot>& snapshot) {
+    //Kept indexes may point into the old snapshot
+    this->cachedIndexes.clear();
+    this->snapshot = snapshot;
+}
+
+//Leave out the files whose paths match these rules, before anything is read
+void ScanSession::setPathFilter(const std::shared_ptr<const PathFilter>& pathFilter) {
+    this->pathFilter = pathFilter;
+}
+
+//Share a scheduler between sessions, so its timings cover every root
+void ScanSession::setScheduler(const std::shared_ptr<FileScheduler>& scheduler) {
+    this->scheduler = scheduler;
+}
+
+//Record every analyzed file, and take the files it already has from it instead of analyzing them
+void ScanSession::setCheckpoint(const std::shared_ptr<ScanCheckpoint>& checkpoint) {
+    this->checkpoint = checkpoint;
+}
+
+//Time every analyzed candidate's parser calls, results reused from the content cache aren't
+void ScanSession::setProfiler(const std::shared_ptr<CandidateProfiler>& profiler) {
+    this->profiler = profiler;
+}
+
+//Queue a file's candidates, its source starts being read ahead right away
+void ScanSession::queueFile(const std::string& filePath, const std::vector<int>& lineNumbers) {
+    QueuedFile queued;
+    queued.filePath = filePath;
+    queued.lineNumbers = lineNumbers;
+    queued.findCandidates = false;
+    this->queue(queued);
+}
+
+//Queue a whole source file, its candidates are the lines grep would have found
+void ScanSession::queueSource(const std::string& filePath) {
+    QueuedFile queued;
+    queued.filePath = filePath;
+    queued.findCandidates = true;
+    this->queue(queued);
+}
+
+//Decide from the path alone whether the file is skipped, so skipped files are never read
+void ScanSession::queue(QueuedFile& queued) {
+    bool skipped = this->classify(queued);
+    queued.resumed = !skipped && this->checkpoint &&
+            this->checkpoint->contains(this->options.projectPath, queued.filePath, queued.lineNumbers);
+    this->queuedFiles.push_back(QueuedFile());
+    std::swap(this->queuedFiles.back(), queued);
+    if (!skipped && !this->queuedFiles.back().resumed && !this->snapshot)
+        this->prefetcher.request(this->options.projectPath + "/" + this->queuedFiles.back().filePath);
+}
+
+//Set whether the file is a test and whether the path rules exclude it, true if it's skipped
+bool ScanSession::classify(QueuedFile& queued) const {
+    queued.isTest = (Util::regexFind(queued.filePath, "[tT][eE][sS][tT]") != std::string::npos);
+    queued.excluded = this->pathFilter && this->pathFilter->isExcluded(queued.filePath);
+    return queued.excluded || (queued.isTest && this->options.skipTest);
+}
+
+size_t ScanSession::getQueuedCount() const {
+    return this->queuedFiles.size();
+}
+
+//Classify the candidates of the file queued first and add them to the totals
+FileResult ScanSession::scanNext() {
+    FileResult result;
+    result.isTest = false;
+    result.skipped = false;
+    result.excluded = false;
+    result.budgetExhausted = false;
+    result.lineCount = 0;
+    if (this->queuedFiles.empty())
+        return result;
+    std::vector<int> lineNumbers;
+    result.filePath.swap(this->queuedFiles.front().filePath);
+    lineNumbers.swap(this->queuedFiles.front().lineNumbers);
+    bool findCandidates = this->queuedFiles.front().findCandidates;
+    bool excluded = this->queuedFiles.front().excluded;
+    bool resumed = this->queuedFiles.front().resumed;
+    result.isTest = this->queuedFiles.front().isTest;
+    this->queuedFiles.pop_front();
+    if (this->skipFile(result, lineNumbers, excluded))
+        return result;
+    if (resumed && this->resumeFile(result, lineNumbers))
+        return result;
+    //The read was requested when it was queued, so it has to be taken either way
+    //A file from the snapshot is used where it is mapped, a missing one reads as empty
+    //and is counted, it's left out of the checkpoint so a resumed run looks for it again
+    std::string contents;
+    ProjectSnapshot::File snapshotFile = { "", 0, NULL, 0 };
+    bool missing = false;
+    if (!this->snapshot)
+        contents = this->prefetcher.take(this->options.projectPath + "/" + result.filePath);
+    else if (!this->snapshot->find(result.filePath, snapshotFile))
+        missing = true;
+    else if (this->contentCache)
+        contents.assign(snapshotFile.contents, snapshotFile.length);
+    if (findCandidates)
+        lineNumbers = this->snapshot ? GrepParser::findCandidates(snapshotFile.contents, snapshotFile.length) :
+                GrepParser::findCandidates(contents);
+    FileWork work = this->analyzeFile(result, lineNumbers, contents, snapshotFile, true, this->options.jobs);
+    work.missing = missing;
+    if (!missing)
+        this->recordFile(result, lineNumbers, work);
+    this->countFile(result, work);
+    return result;
+}
+
+//Count a file left out by the path rules or skipped as a test, true if it was
+bool ScanSession::skipFile(FileResult& result, const std::vector<int>& lineNumbers, bool excluded) {
+    //Excluded files aren't counted with the scanned ones, only with the other excluded files
+    if (excluded) {
+        result.skipped = true;
+        result.excluded = true;
+        result.lineCount = lineNumbers.size();
+        this->totals.excludedFileCount += 1;
+        this->totals.excludedCandidateCount += lineNumbers.size();
+        return true;
+    }
+    //Skipped test files were never read, so a whole source file has no candidates to count
+    if (result.isTest && this->options.skipTest) {
+        result.skipped = true;
+        result.lineCount = lineNumbers.size();
+        this->totals.fileCount += 1;
+        this->totals.candidateCount += lineNumbers.size();
+        this->totals.skippedTestCount += 1;
+        return true;
+    }
+    return false;
+}
+
+//A file part way through being analyzed: its index, its candidates grouped by function,
+//and the budget they share
+struct ScanSession::FileAnalysis {
+    FileAnalysis(const BudgetLimits& limits) : fileBudget(limits.fileSteps, limits.fileSeconds) {};
+    FileResult* result;
+    bool cacheIndex;
+    ContentCache::Key contentKey;
+    std::shared_ptr<JavaFileIndex> fileIndex;
+    std::unique_ptr<JavaParser> parser;
+    long filterLookups;
+    long filterRejections;
+    std::vector<FunctionGroup> groups;
+    WorkBudget fileBudget;
+    FileWork work;
+};
+
+//Classify a file's candidates into its result without adding them to the totals, a big
+//file is split over that many threads. Only with cacheIndex does it use the session's
+//recent indexes, without it nothing of the session is changed, so several files can be
+//analyzed at once.
+ScanSession::FileWork ScanSession::analyzeFile(FileResult& result, const std::vector<int>& lineNumbers,
+        std::string& contents, const ProjectSnapshot::File& snapshotFile, bool cacheIndex, int jobs) {
+    FileAnalysis analysis(this->options.limits);
+    if (!this->beginAnalysis(analysis, result, lineNumbers, contents, snapshotFile, cacheIndex))
+        return analysis.work;
+    //Classify every candidate a function at a time, spreading big files over the threads
+    if ((jobs > 1) && (lineNumbers.size() >= parallelCandidateThreshold))
+        analyzeParallel(*analysis.parser, lineNumbers, analysis.groups, result.candidates, jobs,
+                this->options.limits, analysis.fileBudget, this->profiler.get(), result.filePath);
+    else
+        for (const FunctionGroup& group : analysis.groups)
+            analyzeGroup(*analysis.parser, lineNumbers, group, result.candidates, this->options.limits,
+                    analysis.fileBudget, this->profiler.get(), result.filePath);
+    this->finishAnalysis(analysis);
+    return analysis.work;
+}
+
+//Index the file and group its candidates by function, false if the answers were already
+//known from the same content and nothing is left to analyze
+bool ScanSession::beginAnalysis(FileAnalysis& analysis, FileResult& result, const std::vector<int>& lineNumbers,
+        std::string& contents, const ProjectSnapshot::File& snapshotFile, bool cacheIndex) {
+    FileWork work = { 0, 0, false, 0, 0, false };
+    analysis.work = work;
+    analysis.result = &result;
+    analysis.cacheIndex = cacheIndex;
+    result.lineCount = lineNumbers.size();
+    //The same content asked about the same lines gives the same answers, wherever it is
+    if (this->contentCache) {
+        analysis.contentKey = ContentCache::makeKey(contents, lineNumbers);
+        if (this->contentCache->find(analysis.contentKey, result.candidates)) {
+            analysis.work.reused = true;
+            return false;
+        }
+    }
+    //The index is released with its buffers as soon as this file's candidates are
+    //finished, unless it's one of the recent files being kept
+    std::string fullPath = this->options.projectPath + "/" + result.filePath;
+    if (cacheIndex)
+        analysis.fileIndex = this->getFileIndex(result.filePath, contents, snapshotFile);
+    else
+        analysis.fileIndex.reset(this->snapshot ? new JavaFileIndex(fullPath, snapshotFile) :
+                new JavaFileIndex(fullPath, contents));
+    //A kept index has counted lookups on earlier scans already
+    analysis.filterLookups = analysis.fileIndex->filterLookups;
+    analysis.filterRejections = analysis.fileIndex->filterRejections;
+    analysis.parser.reset(new JavaParser(analysis.fileIndex));
+    analysis.groups = groupByFunction(*analysis.parser, lineNumbers);
+    result.candidates.resize(lineNumbers.size());
+    return true;
+}
+
+//Once every group is classified, share the answers and count the work that went into them
+void ScanSession::finishAnalysis(FileAnalysis& analysis) {
+    FileResult& result = *analysis.result;
+    //Summaries built over an exhausted budget are wrong, so don't keep them around
+    result.budgetExhausted = analysis.fileBudget.isExhausted();
+    if (result.budgetExhausted) {
+        if (analysis.cacheIndex)
+            this->forgetFile(result.filePath);
+    }
+    //Answers cut short by a budget depend on timing, so only complete ones are shared
+    else if (this->contentCache)
+        this->contentCache->insert(analysis.contentKey, result.candidates);
+    //Count how often a prepared function served more than one candidate
+    analysis.work.functionContexts = analysis.groups.size();
+    for (const FunctionGroup& group : analysis.groups)
+        if (group.candidates.size() > 1)
+            analysis.work.sharedContexts += group.candidates.size();
+    analysis.work.filterLookups = analysis.fileIndex->filterLookups - analysis.filterLookups;
+    analysis.work.filterRejections = analysis.fileIndex->filterRejections - analysis.filterRejections;
+    //The parser's caches and, unless it's kept, the index go with it
+    analysis.parser.reset();
+    analysis.fileIndex.reset();
+}
+
+//Add an analyzed file to the totals
+void ScanSession::countFile(const FileResult& result, const FileWork& work) {
+    //Count the number of files and add number of lines
+    this->totals.fileCount += 1;
+    this->totals.candidateCount += result.lineCount;
+    //Count the number of file paths containing "test"
+    if (result.isTest)
+        this->totals.testFileCount += 1;
+    if (work.reused)
+        this->totals.reusedFileCount += 1;
+    this->totals.functionContextCount += work.functionContexts;
+    this->totals.sharedContextCount += work.sharedContexts;
+    this->totals.filterLookupCount += work.filterLookups;
+    this->totals.filterRejectionCount += work.filterRejections;
+    if (work.missing) {
+        this->totals.snapshotMissCount += 1;
+        this->totals.snapshotMissCandidateCount += result.lineCount;
+    }
+    this->addResult(result);
+}
+
+//Count a file's result from the checkpoint in its place, true if it had one
+bool ScanSession::resumeFile(FileResult& result, const std::vector<int>& lineNumbers) {
+    ScanCheckpoint::Entry entry;
+    if (!this->checkpoint || !this->checkpoint->take(this->options.projectPath, result.filePath, lineNumbers, entry))
+        return false;
+    std::swap(result, entry.result);
+    FileWork work = { entry.functionContexts, entry.sharedContexts, entry.reused, entry.filterLookups,
+            entry.filterRejections, false };
+    this->countFile(result, work);
+    return true;
+}
+
+//Keep an analyzed file's result in the checkpoint, can be called from any thread
+void ScanSession::recordFile(const FileResult& result, const std::vector<int>& lineNumbers, const FileWork& work) {
+    if (!this->checkpoint)
+        return;
+    ScanCheckpoint::Entry entry = { result, ScanCheckpoint::hashLines(lineNumbers), work.functionContexts, work.sharedContexts, work.reused,
+            work.filterLookups, work.filterRejections };
+    this->checkpoint->record(this->options.projectPath, entry);
+}
+
+FileResult ScanSession::scanFile(const std::string& filePath, const std::vector<int>& lineNumbers) {
+    //Anything queued before it has to be scanned first to keep the reads in order
+    this->queueFile(filePath, lineNumbers);
+    FileResult result;
+    do {
+        result = this->scanNext();
+    } while (!this->queuedFiles.empty());
+    return result;
+}
+
+FileResult ScanSession::scanSource(const std::string& filePath) {
+    this->queueSource(filePath);
+    FileResult result;
+    do {
+        result = this->scanNext();
+    } while (!this->queuedFiles.empty());
+    return result;
+}
+
+//Scan the given files and candidate lines, like a grep input that was already parsed
+void ScanSession::scanFiles(const std::map<std::string, std::vector<int>>& fileLines,
+        ProgressReporter* progress, std::vector<FileResult>* results) {
+    if ((this->options.jobs > 1) && this->queuedFiles.empty()) {
+        this->scanScheduled(fileLines, progress, results);
+        return;
+    }
+    if (progress != NULL)
+        progress->setTotalFiles(this->totals.fileCount + this->queuedFiles.size() + fileLines.size());
+    std::map<std::string, std::vector<int>>::const_iterator nextFile = fileLines.begin();
+    while (true) {
+        while ((nextFile != fileLines.end()) && (this->queuedFiles.size() <= this->options.prefetchDepth)) {
+            this->queueFile(nextFile->first, nextFile->second);
+            ++nextFile;
+        }
+        if (this->queuedFiles.empty())
+            break;
+        if (progress != NULL)
+            progress->startFile(this->queuedFiles.front().filePath);
+        size_t candidateCount = this->queuedFiles.front().lineNumbers.size();
+        FileResult result = this->scanNext();
+        if (progress != NULL)
+            progress->finishFile(candidateCount);
+        if (results != NULL)
+            results->push_back(result);
+    }
+}
+
+//Analyze the files on the session's threads, handing out the most expensive first, then
+//add them to the totals in path order so the report is the same as a serial run's.
+//Files with many candidates are split between the threads as they come up, so the biggest
+//file doesn't hold up the end of the scan on one thread. The threads read their own files,
+//so nothing is read ahead.
+void ScanSession::scanScheduled(const std::map<std::string, std::vector<int>>& fileLines,
+        ProgressReporter* progress, std::vector<FileResult>* results) {
+    struct ScheduledFile {
+        const std::string* filePath;
+        const std::vector<int>* lineNumbers;
+        bool skipped;
+        bool excluded;
+        bool resumed;
+        FileResult result;
+        FileWork work;
+        double seconds;
+    };
+    if (progress != NULL)
+        progress->setTotalFiles(this->totals.fileCount + fileLines.size());
+    //Skipped files are decided from the path, the rest get an estimate to be ordered by
+    std::vector<ScheduledFile> files(fileLines.size());
+    std::vector<FileScheduler::Job> jobs;
+    std::vector<size_t> jobFiles;
+    size_t i = 0;
+    for (std::map<std::string, std::vector<int>>::const_iterator entry = fileLines.begin();
+            entry != fileLines.end(); ++entry, i++) {
+        ScheduledFile& file = files[i];
+        file.filePath = &entry->first;
+        file.lineNumbers = &entry->second;
+        QueuedFile queued;
+        queued.filePath = entry->first;
+        file.skipped = this->classify(queued);
+        file.excluded = queued.excluded;
+        file.result.filePath = entry->first;
+        file.result.isTest = queued.isTest;
+        file.result.skipped = false;
+        file.result.excluded = false;
+        file.result.budgetExhausted = false;
+        file.result.lineCount = 0;
+        file.work = { 0, 0, false, 0, 0, false };
+        file.seconds = 0;
+        file.resumed = !file.skipped && this->checkpoint &&
+                this->checkpoint->contains(this->options.projectPath, entry->first, entry->second);
+        if (file.skipped || file.resumed)
+            continue;
+        FileScheduler::Job job = { entry->first, 0, entry->second.size() };
+        ProjectSnapshot::File snapshotFile;
+        struct stat fileStat;
+        if (this->snapshot) {
+            if (this->snapshot->find(entry->first, snapshotFile))
+                job.fileSize = snapshotFile.length;
+        }
+        else if (stat((this->options.projectPath + "/" + entry->first).c_str(), &fileStat) == 0)
+            job.fileSize = fileStat.st_size;
+        jobs.push_back(job);
+        jobFiles.push_back(i);
+    }
+    std::vector<size_t> order = this->scheduler->order(jobs);
+    //A file with many candidates is split into slices of its function groups, which any
+    //thread without a file of its own picks up. Its time is the sum over the threads.
+    struct SplitFile {
+        SplitFile(const BudgetLimits& limits) : analysis(limits) {};
+        ScheduledFile* file;
+        FileAnalysis analysis;
+        bool missing;
+        std::vector<FunctionGroup> slices;
+        size_t nextSlice;
+        size_t finishedSlices;
+    };
+    std::mutex lock;
+    std::condition_variable opened;
+    std::deque<std::shared_ptr<SplitFile>> splitFiles;
+    size_t nextJob = 0;
+    int openingCount = 0;
+    auto read = [&](ScheduledFile& file, std::string& contents, ProjectSnapshot::File& snapshotFile) {
+        if (progress != NULL)
+            progress->startFile(*file.filePath);
+        if (!this->snapshot)
+            contents = FilePrefetcher::readFile(this->options.projectPath + "/" + *file.filePath);
+        else if (!this->snapshot->find(*file.filePath, snapshotFile))
+            return true;
+        else if (this->contentCache)
+            contents.assign(snapshotFile.contents, snapshotFile.length);
+        return false;
+    };
+    auto finish = [&](ScheduledFile& file, bool missing) {
+        file.work.missing = missing;
+        if (!missing)
+            this->recordFile(file.result, *file.lineNumbers, file.work);
+        if (progress != NULL)
+            progress->finishFile(file.lineNumbers->size());
+    };
+    auto seconds = [](std::chrono::steady_clock::time_point startTime) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+    //A small file is analyzed whole by the thread that takes it
+    auto analyze = [&](ScheduledFile& file) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        std::string contents;
+        ProjectSnapshot::File snapshotFile = { "", 0, NULL, 0 };
+        bool missing = read(file, contents, snapshotFile);
+        file.work = this->analyzeFile(file.result, *file.lineNumbers, contents, snapshotFile, false, 1);
+        finish(file, missing);
+        file.seconds = seconds(startTime);
+    };
+    //A big one is indexed and grouped by the thread that takes it, then its slices are handed out
+    auto open = [&](ScheduledFile& file) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        std::shared_ptr<SplitFile> split(new SplitFile(this->options.limits));
+        split->file = &file;
+        split->nextSlice = 0;
+        split->finishedSlices = 0;
+        std::string contents;
+        ProjectSnapshot::File snapshotFile = { "", 0, NULL, 0 };
+        split->missing = read(file, contents, snapshotFile);
+        if (this->beginAnalysis(split->analysis, file.result, *file.lineNumbers, contents, snapshotFile, false))
+            split->slices = sliceGroups(split->analysis.groups, file.lineNumbers->size(), this->options.jobs);
+        file.seconds = seconds(startTime);
+        if (split->slices.empty()) {
+            file.work = split->analysis.work;
+            finish(file, split->missing);
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        splitFiles.push_back(split);
+    };
+    //The thread finishing a file's last slice finishes the file
+    auto analyzeSlice = [&](const std::shared_ptr<SplitFile>& split, size_t slice) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        ScheduledFile& file = *split->file;
+        JavaParser context(split->analysis.fileIndex);
+        analyzeGroup(context, *file.lineNumbers, split->slices[slice], file.result.candidates,
+                this->options.limits, split->analysis.fileBudget, this->profiler.get(), *file.filePath);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            file.seconds += seconds(startTime);
+            if (++split->finishedSlices < split->slices.size())
+                return;
+        }
+        startTime = std::chrono::steady_clock::now();
+        this->finishAnalysis(split->analysis);
+        file.work = split->analysis.work;
+        finish(file, split->missing);
+        file.seconds += seconds(startTime);
+    };
+    //Each thread helps with the slices of a split file first, then takes the next most
+    //expensive file, and waits only while a file it could help with is being opened
+    auto work = [&]() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            while (!splitFiles.empty() && (splitFiles.front()->nextSlice == splitFiles.front()->slices.size()))
+                splitFiles.pop_front();
+            if (!splitFiles.empty()) {
+                std::shared_ptr<SplitFile> split = splitFiles.front();
+                size_t slice = split->nextSlice++;
+                guard.unlock();
+                analyzeSlice(split, slice);
+                guard.lock();
+            }
+            else if (nextJob < order.size()) {
+                ScheduledFile& file = files[jobFiles[order[nextJob++]]];
+                bool splitting = file.lineNumbers->size() >= parallelCandidateThreshold;
+                if (splitting)
+                    openingCount++;
+                guard.unlock();
+                if (splitting)
+                    open(file);
+                else
+                    analyze(file);
+                guard.lock();
+                if (splitting) {
+                    openingCount--;
+                    opened.notify_all();
+                }
+            }
+            else if (openingCount > 0)
+                opened.wait(guard);
+            else
+                break;
+        }
+    };
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int j = 1; j < std::min<size_t>(this->options.jobs, order.size()); j++)
+        threads.push_back(std::thread(work));
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+    this->totals.makespanSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+    //Everything is added up in path order, and the timings kept for the next run's estimates
+    for (ScheduledFile& file : files) {
+        if (file.skipped || file.resumed) {
+            if (file.skipped)
+                this->skipFile(file.result, *file.lineNumbers, file.excluded);
+            else
+                this->resumeFile(file.result, *file.lineNumbers);
+            if (progress != NULL)
+                progress->finishFile(file.lineNumbers->size());
+        }
+        else {
+            this->countFile(file.result, file.work);
+            this->scheduler->recordTiming(*file.filePath, file.seconds);
+            this->totals.workSeconds += file.seconds;
+            this->totals.longestFileSeconds = std::max(this->totals.longestFileSeconds, file.seconds);
+        }
+        if (results != NULL) {
+            results->push_back(FileResult());
+            std::swap(results->back(), file.result);
+        }
+    }
+}
+
+//Scan every file of a grep input, keeping the next files read ahead of the analysis
+void ScanSession::scanGrep(GrepParser& grepParser, ProgressReporter* progress) {
+    //Get the map between file paths and sets of target lines
+    //With a memory budget the grep input is streamed one file at a time instead
+    std::map<std::string, std::vector<int>> fileLines;
+    if (this->options.maxMemory == 0) {
+        fileLines = grepParser.parseInput();
+        //With several threads whole files are handed out, longest first
+        if ((this->options.jobs > 1) && this->queuedFiles.empty()) {
+            this->scanScheduled(fileLines, progress, NULL);
+            return;
+        }
+        if (progress != NULL)
+            progress->setTotalFiles(this->totals.fileCount + this->queuedFiles.size() + fileLines.size());
+    }
+    std::map<std::string, std::vector<int>>::const_iterator nextFile = fileLines.begin();
+    bool inputDone = false;
+    std::string filePath;
+    std::vector<int> lineNumbers;
+    while (true) {
+        //Keep the next files requested ahead of the one about to be analyzed
+        while (!inputDone && (this->queuedFiles.size() <= this->options.prefetchDepth)) {
+            //Pull the next file either from the map or straight from the stream
+            if (this->options.maxMemory == 0) {
+                if (nextFile == fileLines.end()) {
+                    inputDone = true;
+                    break;
+                }
+                this->queueFile(nextFile->first, nextFile->second);
+                ++nextFile;
+            }
+            else {
+                if (!grepParser.parseNextFile(filePath, lineNumbers)) {
+                    inputDone = true;
+                    break;
+                }
+                this->queueFile(filePath, lineNumbers);
+            }
+        }
+        if (this->queuedFiles.empty())
+            break;
+        if (progress != NULL)
+            progress->startFile(this->queuedFiles.front().filePath);
+        size_t candidateCount = this->queuedFiles.front().lineNumbers.size();
+        this->scanNext();
+        if (progress != NULL)
+            progress->finishFile(candidateCount);
+    }
+}
+
+//Scan whole source files, keeping the next ones read ahead of the analysis
+//The result of every file is kept in results unless it's NULL
+void ScanSession::scanSources(const std::vector<std::string>& filePaths, ProgressReporter* progress,
+        std::vector<FileResult>* results) {
+    if (progress != NULL)
+        progress->setTotalFiles(this->totals.fileCount + this->queuedFiles.size() + filePaths.size());
+    std::vector<std::string>::const_iterator nextFile = filePaths.begin();
+    while (true) {
+        while ((nextFile != filePaths.end()) && (this->queuedFiles.size() <= this->options.prefetchDepth)) {
+            this->queueSource(*nextFile);
+            ++nextFile;
+        }
+        if (this->queuedFiles.empty())
+            break;
+        if (progress != NULL)
+            progress->startFile(this->queuedFiles.front().filePath);
+        FileResult result = this->scanNext();
+        if (progress != NULL)
+            progress->finishFile(result.candidates.size());
+        if (results != NULL)
+            results->push_back(result);
+    }
+}
+
+//Take a file's earlier results back out of the totals, before adding its rescan
+//The lists of uses only grow, so they aren't changed
+void ScanSession::subtractResult(const FileResult& result) {
+    if (result.excluded) {
+        this->totals.excludedFileCount -= 1;
+        this->totals.excludedCandidateCount -= result.lineCount;
+        return;
+    }
+    if (result.isTest && result.skipped)
+        this->totals.skippedTestCount -= 1;
+    this->totals.fileCount -= 1;
+    this->totals.candidateCount -= result.lineCount;
+    if (result.isTest && !result.skipped)
+        this->totals.testFileCount -= 1;
+    if (result.budgetExhausted)
+        this->totals.fileBudgetCount -= 1;
+    for (const CandidateResult& candidate : result.candidates) {
+        if (candidate.category == CandidateResult::NotRuntime)
+            continue;
+        this->totals.runtimeCount -= 1;
+        for (int j = 0; j < candidate.types.size(); j++) {
+            Symbol type = candidate.types[j];
+            //Types nothing uses any more drop out of the table
+            if (--this->totals.typeCounts[type] == 0)
+                this->totals.typeCounts.erase(type);
+            if (candidate.typeHardcoded[j])
+                this->totals.typeHardcoded[type] -= 1;
+            if (candidate.typeInput[j])
+                this->totals.typeInput[type] -= 1;
+        }
+        if (candidate.category == CandidateResult::Input)
+            this->totals.inputCount -= 1;
+        else if (candidate.category == CandidateResult::Hardcoded)
+            this->totals.hardcodedCount -= 1;
+        else if (candidate.category == CandidateResult::Unresolved)
+            this->totals.unresolvedCount -= 1;
+    }
+}
+
+//Drop a file's index, for when the file has changed since it was scanned
+void ScanSession::forgetFile(const std::string& filePath) {
+    for (size_t i = 0; i < this->cachedIndexes.size(); i++) {
+        if (this->cachedIndexes[i].first == filePath) {
+            this->cachedIndexes.erase(this->cachedIndexes.begin() + i);
+            return;
+        }
+    }
+}
+
+const ScanTotals& ScanSession::getTotals() const {
+    return this->totals;
+}
+
+//Index a file, or reuse the index and summaries from the last time it was scanned
+std::shared_ptr<JavaFileIndex> ScanSession::getFileIndex(const std::string& filePath, std::string& contents,
+        const ProjectSnapshot::File& snapshotFile) {
+    std::string fullPath = this->options.projectPath + "/" + filePath;
+    for (size_t i = 0; i < this->cachedIndexes.size(); i++) {
+        if (this->cachedIndexes[i].first == filePath) {
+            std::shared_ptr<JavaFileIndex> fileIndex = this->cachedIndexes[i].second;
+            //Most recently used goes to the back
+            this->cachedIndexes.erase(this->cachedIndexes.begin() + i);
+            this->cachedIndexes.push_back(std::make_pair(filePath, fileIndex));
+            return fileIndex;
+        }
+    }
+    std::shared_ptr<JavaFileIndex> fileIndex(this->snapshot ? new JavaFileIndex(fullPath, snapshotFile) :
+            new JavaFileIndex(fullPath, contents));
+    if (this->options.cachedFiles > 0) {
+        this->cachedIndexes.push_back(std::make_pair(filePath, fileIndex));
+        if (this->cachedIndexes.size() > this->options.cachedFiles)
+            this->cachedIndexes.pop_front();
+    }
+    return fileIndex;
+}
+
+//Add a file's results up in line order, the same as a serial run
+void ScanSession::addResult(const FileResult& result) {
+    if (result.budgetExhausted)
+        this->totals.fileBudgetCount += 1;
+    for (const CandidateResult& candidate : result.candidates) {
+        if (candidate.category == CandidateResult::NotRuntime)
+            continue;
+        //Add to the number of functions actually containing runtime
+        this->totals.runtimeCount += 1;
+        for (int j = 0; j < candidate.types.size(); j++) {
+            Symbol type = candidate.types[j];
+            this->totals.typeCounts[type] += 1;
+            if (candidate.typeHardcoded[j])
+                this->totals.typeHardcoded[type] += 1;
+            if (candidate.typeInput[j])
+                this->totals.typeInput[type] += 1;
+        }
+        //Keep track of the usages for printing with the flags
+        std::string usage = result.filePath + ": " + std::to_string(candidate.lineNumber) + ":\n" +
+                candidate.statement;
+        //Keep track of how many functions have input and how many are hardcoded
+        if (candidate.category == CandidateResult::Input) {
+            this->totals.inputCount += 1;
+            this->inputUses.push_back(usage);
+        }
+        else if (candidate.category == CandidateResult::Hardcoded) {
+            this->totals.hardcodedCount += 1;
+            this->hardcodedUses.push_back(usage);
+        }
+        else if (candidate.category == CandidateResult::Unresolved) {
+            this->totals.unresolvedCount += 1;
+            this->unresolvedUses.push_back(usage);
+        }
+        else {
+            this->otherUses.push_back(usage);
+        }
+    }
+}
+
+void ScanSession::writeReport(std::ostream& output, bool printHardcode, bool printInput, bool printOther) {
+    const ScanTotals& totals = this->totals;
+    //Print the number omitted due to not being Runtime.exec()
+    output << totals.candidateCount << " candidates given, ";
+    output << (totals.candidateCount - totals.runtimeCount);
+    output << " omitted for being commented or lacking Runtime" << std::endl;
+    //Print the total, hardcoded, and containing input
+    output << "Out of " << totals.runtimeCount << " uses: ";
+    output << totals.hardcodedCount << " hardcoded, ";
+    output << totals.inputCount << " from function input, ";
+    output << (totals.runtimeCount - totals.hardcodedCount - totals.inputCount - totals.unresolvedCount);
+    output << " other";
+    if (totals.unresolvedCount > 0)
+        output << ", " << totals.unresolvedCount << " unresolved (budget)";
+    output << std::endl;
+    //Print the number of "test" files if they weren't skipped
+    if (!this->options.skipTest) {
+        output << totals.testFileCount << "/" << totals.fileCount;
+        output << " file paths contain \"test\"" << std::endl;
+    }
+    else
+        output << totals.skippedTestCount << " test files skipped" << std::endl;
+    //Print the files the path rules left out, they aren't in the counts above
+    if (totals.excludedFileCount > 0) {
+        output << totals.excludedFileCount << " files with " << totals.excludedCandidateCount;
+        output << " candidates excluded by path rules" << std::endl;
+    }
+    //Files the snapshot doesn't have were scanned as empty, so their candidates count as lacking Runtime
+    if (totals.snapshotMissCount > 0) {
+        output << totals.snapshotMissCount << " files with " << totals.snapshotMissCandidateCount;
+        output << " candidates were not in the snapshot" << std::endl;
+    }
+    //Print header for the function table
+    output << "\nExec Input Table\n" << std::endl;
+    //Print all of the types, their total/hardcoded/input count
+    output << std::left << std::setw(20) << "Variable Type" << std::right << " | ";
+    output << std::left << std::setw(7) << "Total" << std::right << " | ";
+    output << std::left << std::setw(9) << "Hardcoded" << std::right << " | ";
+    output << std::left << std::setw(7) << "Input" << std::endl;
+    output << std::string(48, '-') << std::endl;
+    //Types are printed alphabetically by name, not in the order they were interned
+    std::vector<Symbol> types;
+    for (auto const& x : totals.typeCounts)
+        types.push_back(x.first);
+    std::sort(types.begin(), types.end(), Symbols::lessByName);
+    //Look through typeCount, typeHardcoded, typeInput and print values
+    for (Symbol type : types) {
+        std::unordered_map<Symbol,int>::const_iterator hardcoded = totals.typeHardcoded.find(type);
+        std::unordered_map<Symbol,int>::const_iterator input = totals.typeInput.find(type);
+        output << std::left << std::setw(20) << Symbols::getName(type) << std::right << " | ";
+        output << std::left << std::setw(7) << totals.typeCounts.at(type) << std::right << " | ";
+        output << std::left << std::setw(9) << (hardcoded == totals.typeHardcoded.end() ? 0 : hardcoded->second) << " | ";
+        output << std::left << std::setw(7) << (input == totals.typeInput.end() ? 0 : input->second) << std::endl; 
+    }
+    
+    //Print all of the hardcoded uses
+    if (printHardcode) {
+        output << "\nHardcoded Uses:" << std::endl;
+        this->hardcodedUses.write(output);
+    }
+    //Print all of the input uses
+    if (printInput) {
+        output << "\nInput Uses:" << std::endl;
+        this->inputUses.write(output);
+    }
+    //Print all of the other uses
+    if (printOther) {
+        output << "\nOther Uses:" << std::endl;
+        this->otherUses.write(output);
+    }
+    //Always list what ran out of budget, those locations need a look by hand
+    if (totals.unresolvedCount > 0) {
+        output << "\nUnresolved (budget) Uses:" << std::endl;
+        this->unresolvedUses.write(output);
+    }
+}
+
+void ScanSession::writeStatistics(std::ostream& output) {
+    const BudgetLimits& limits = this->options.limits;
+    output << "\nScan Statistics:" << std::endl;
+    output << "Files scanned: " << this->totals.fileCount << std::endl;
+    output << "Elapsed time: " << (long)difftime(time(NULL), this->scanStart) << " s" << std::endl;
+    output << "Peak memory: " << getPeakMemory() << " KB";
+    if (this->options.maxMemory != 0)
+        output << " (budget " << this->options.maxMemory / 1024 << " KB)";
+    output << std::endl;
+    output << "Prefetch depth: " << this->prefetcher.getDepth() << ", analysis waited on I/O for ";
+    output << this->prefetcher.getStarvedCount() << "/" << this->prefetcher.getTakeCount() << " files (";
+    output << (long)(this->prefetcher.getStarvedSeconds() * 1000) << " ms)" << std::endl;
+    output << "Function contexts: " << this->totals.functionContextCount << ", ";
+    output << this->totals.sharedContextCount << " candidates shared a context with another" << std::endl;
+    if (this->contentCache)
+        output << "Content reused: " << this->totals.reusedFileCount << "/" << this->totals.fileCount <<
+                " files matched content already analyzed" << std::endl;
+    if (this->totals.filterLookupCount > 0)
+        output << "Identifier filters: " << this->totals.filterRejectionCount << "/" <<
+                this->totals.filterLookupCount << " declaration lookups ruled out without a scan (" <<
+                (long)(100 * this->totals.filterRejectionCount / this->totals.filterLookupCount) << "%)" << std::endl;
+    //How close the threads came to finishing together, the longest file bounds it from below
+    if (this->totals.makespanSeconds > 0) {
+        output << "Schedule: " << (long)(this->totals.makespanSeconds * 1000) << " ms makespan for ";
+        output << (long)(this->totals.workSeconds * 1000) << " ms of file work on " << this->options.jobs;
+        output << " threads (" << (long)(100 * this->totals.workSeconds /
+                (this->totals.makespanSeconds * this->options.jobs)) << "% busy), longest file ";
+        output << (long)(this->totals.longestFileSeconds * 1000) << " ms" << std::endl;
+    }
+    if (limits.candidateSteps || limits.candidateSeconds || limits.fileSteps || limits.fileSeconds) {
+        output << "Budget exhausted: " << this->totals.unresolvedCount << " candidates unresolved, ";
+        output << this->totals.fileBudgetCount << " files ran out of their file budget" << std::endl;
+    }
+}
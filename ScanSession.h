@@ -0,0 +1,258 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ScanSession.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 9:58 PM
+ */
+
+#ifndef SCANSESSION_H
+#define SCANSESSION_H
+
+#include <stdint.h>
+#include <ctime>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CandidateProfiler.h"
+#include "FilePrefetcher.h"
+#include "FileScheduler.h"
+#include "GrepParser.h"
+#include "JavaParser.h"
+#include "PathFilter.h"
+#include "ProgressReporter.h"
+#include "ProjectSnapshot.h"
+#include "UseList.h"
+
+class ScanCheckpoint;
+
+//Result of classifying one candidate line
+struct CandidateResult {
+    enum Category { NotRuntime, Hardcoded, Input, Other, Unresolved };
+    Category category;
+    int lineNumber;
+    std::string statement;
+    //The type of each argument to exec, and whether it was hardcoded or input
+    std::vector<Symbol> types;
+    std::vector<bool> typeHardcoded;
+    std::vector<bool> typeInput;
+};
+
+//The candidates of one file, in the order they were given
+struct FileResult {
+    std::string filePath;
+    bool isTest;
+    //Test files are skipped without being read when the session skips tests
+    bool skipped;
+    //Skipped by the path rules, such files aren't counted with the scanned files at all
+    bool excluded;
+    bool budgetExhausted;
+    //Lines given for the file, skipped files have no candidate results for them
+    int lineCount;
+    std::vector<CandidateResult> candidates;
+};
+
+//Budgets that keep one pathological candidate or file from holding up the scan, 0 is unlimited
+struct BudgetLimits {
+    long candidateSteps;
+    double candidateSeconds;
+    long fileSteps;
+    double fileSeconds;
+};
+
+struct ScanOptions {
+    ScanOptions();
+    //Candidate paths are relative to the project path
+    std::string projectPath;
+    bool skipTest;
+    //Memory budget in bytes, 0 means keep everything in memory
+    size_t maxMemory;
+    //Number of upcoming files to read ahead of the analysis
+    int prefetchDepth;
+    //Number of threads for analyzing the candidates of a file
+    int jobs;
+    //Number of recently scanned files whose indexes and summaries are kept, for callers
+    //that scan the same files again, 0 releases each file's as soon as it's finished
+    int cachedFiles;
+    BudgetLimits limits;
+};
+
+//Results of files already analyzed, by their content and the lines asked about,
+//so identical files in other trees (branches of the same project) aren't analyzed again.
+//Shared between sessions, it can be used from several threads.
+class ContentCache {
+public:
+    struct Key {
+        uint64_t hash;
+        uint64_t check;
+        size_t size;
+        std::vector<int> lineNumbers;
+        bool operator<(const Key& other) const;
+    };
+    ContentCache();
+    static Key makeKey(const std::string& contents, const std::vector<int>& lineNumbers);
+    bool find(const Key& key, std::vector<CandidateResult>& candidates);
+    void insert(const Key& key, const std::vector<CandidateResult>& candidates);
+    long getLookupCount();
+    long getHitCount();
+private:
+    ContentCache(const ContentCache&);
+    ContentCache& operator=(const ContentCache&);
+    std::mutex lock;
+    std::map<Key, std::vector<CandidateResult>> entries;
+    long lookupCount;
+    long hitCount;
+};
+
+//Running totals over everything a session has scanned
+struct ScanTotals {
+    ScanTotals();
+    int fileCount;
+    int testFileCount;
+    int candidateCount;
+    int runtimeCount;
+    int hardcodedCount;
+    int inputCount;
+    int unresolvedCount;
+    int fileBudgetCount;
+    //The function contexts prepared and the candidates that shared one
+    long functionContextCount;
+    long sharedContextCount;
+    //Files whose results came from identical content scanned before
+    int reusedFileCount;
+    //Test files skipped with -t, they are still counted in fileCount
+    int skippedTestCount;
+    //Files the path rules left out, and the candidates given for them
+    int excludedFileCount;
+    int excludedCandidateCount;
+    //Files given that the snapshot doesn't have, scanned as empty, and their candidates
+    int snapshotMissCount;
+    int snapshotMissCandidateCount;
+    //Wall time of scans spread over the threads file by file, against the time the files took
+    double makespanSeconds;
+    double workSeconds;
+    double longestFileSeconds;
+    //Declaration lookups the identifier filters answered, and how many they ruled out
+    long filterLookupCount;
+    long filterRejectionCount;
+    //Uses of each exec argument type, and how many were hardcoded or input
+    std::unordered_map<Symbol,int> typeCounts;
+    std::unordered_map<Symbol,int> typeHardcoded;
+    std::unordered_map<Symbol,int> typeInput;
+};
+
+//Classifies candidates file by file and keeps the totals for a report
+//Files can be given one at a time or as a whole grep input, the session keeps its
+//prefetcher between calls, and the indexes of recent files only when cachedFiles is set
+class ScanSession {
+public:
+    ScanSession(const ScanOptions& options);
+    const ScanOptions& getOptions() const;
+    void setContentCache(const std::shared_ptr<ContentCache>& contentCache);
+    void setSnapshot(const std::shared_ptr<ProjectSnapshot>& snapshot);
+    void setPathFilter(const std::shared_ptr<const PathFilter>& pathFilter);
+    void setProfiler(const std::shared_ptr<CandidateProfiler>& profiler);
+    void setScheduler(const std::shared_ptr<FileScheduler>& scheduler);
+    void setCheckpoint(const std::shared_ptr<ScanCheckpoint>& checkpoint);
+    void queueFile(const std::string& filePath, const std::vector<int>& lineNumbers);
+    void queueSource(const std::string& filePath);
+    size_t getQueuedCount() const;
+    FileResult scanNext();
+    FileResult scanFile(const std::string& filePath, const std::vector<int>& lineNumbers);
+    FileResult scanSource(const std::string& filePath);
+    void scanGrep(GrepParser& grepParser, ProgressReporter* progress);
+    void scanFiles(const std::map<std::string, std::vector<int>>& fileLines, ProgressReporter* progress,
+            std::vector<FileResult>* results);
+    void scanSources(const std::vector<std::string>& filePaths, ProgressReporter* progress,
+            std::vector<FileResult>* results);
+    void subtractResult(const FileResult& result);
+    void forgetFile(const std::string& filePath);
+    const ScanTotals& getTotals() const;
+    void writeReport(std::ostream& output, bool printHardcode, bool printInput, bool printOther);
+    void writeStatistics(std::ostream& output);
+private:
+    ScanSession(const ScanSession&);
+    ScanSession& operator=(const ScanSession&);
+    //A file waiting to be scanned, without lines its candidates are found when it's read
+    struct QueuedFile {
+        std::string filePath;
+        std::vector<int> lineNumbers;
+        bool findCandidates;
+        bool isTest;
+        bool excluded;
+        //Finished on an earlier run, its result is taken from the checkpoint
+        bool resumed;
+    };
+    //What analyzing a file added up to, counted once the file's turn comes
+    struct FileWork {
+        long functionContexts;
+        long sharedContexts;
+        bool reused;
+        long filterLookups;
+        long filterRejections;
+        bool missing;
+    };
+    bool classify(QueuedFile& queued) const;
+    void queue(QueuedFile& queued);
+    bool skipFile(FileResult& result, const std::vector<int>& lineNumbers, bool excluded);
+    FileWork analyzeFile(FileResult& result, const std::vector<int>& lineNumbers, std::string& contents,
+            const ProjectSnapshot::File& snapshotFile, bool cacheIndex, int jobs);
+    struct FileAnalysis;
+    bool beginAnalysis(FileAnalysis& analysis, FileResult& result, const std::vector<int>& lineNumbers,
+            std::string& contents, const ProjectSnapshot::File& snapshotFile, bool cacheIndex);
+    void finishAnalysis(FileAnalysis& analysis);
+    void countFile(const FileResult& result, const FileWork& work);
+    bool resumeFile(FileResult& result, const std::vector<int>& lineNumbers);
+    void recordFile(const FileResult& result, const std::vector<int>& lineNumbers, const FileWork& work);
+    void scanScheduled(const std::map<std::string, std::vector<int>>& fileLines, ProgressReporter* progress,
+            std::vector<FileResult>* results);
+    std::shared_ptr<JavaFileIndex> getFileIndex(const std::string& filePath, std::string& contents,
+            const ProjectSnapshot::File& snapshotFile);
+    void addResult(const FileResult& result);
+    ScanOptions options;
+    ScanTotals totals;
+    std::shared_ptr<ContentCache> contentCache;
+    std::shared_ptr<ProjectSnapshot> snapshot;
+    std::shared_ptr<const PathFilter> pathFilter;
+    std::shared_ptr<CandidateProfiler> profiler;
+    std::shared_ptr<FileScheduler> scheduler;
+    std::shared_ptr<ScanCheckpoint> checkpoint;
+    time_t scanStart;
+    FilePrefetcher prefetcher;
+    std::deque<QueuedFile> queuedFiles;
+    std::deque<std::pair<std::string, std::shared_ptr<JavaFileIndex>>> cachedIndexes;
+    UseList hardcodedUses;
+    UseList inputUses;
+    UseList otherUses;
+    UseList unresolvedUses;
+};
+
+#endif /* SCANSESSION_H */
@@ -0,0 +1,228 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   StructuralIndex.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#include "StructuralIndex.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace StructuralIndex {
+
+//One bit per byte of a 64 byte block, bit i is byte i
+struct Block {
+    uint64_t newline;
+    uint64_t openBrace;
+    uint64_t closeBrace;
+    uint64_t openParenthesis;
+    uint64_t slash;
+    uint64_t star;
+    uint64_t blank;
+};
+
+#if defined(__SSE2__)
+static bool vectorizedIndex = true;
+
+static uint64_t matchByte(const __m128i chunks[4], char c) {
+    __m128i wanted = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++)
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], wanted)) << (16 * i);
+    return mask;
+}
+
+static void classifyVectorized(const char* text, Block& block) {
+    __m128i chunks[4];
+    for (int i = 0; i < 4; i++)
+        chunks[i] = _mm_loadu_si128((const __m128i*)(text + 16 * i));
+    block.newline = matchByte(chunks, '\n');
+    block.openBrace = matchByte(chunks, '{');
+    block.closeBrace = matchByte(chunks, '}');
+    block.openParenthesis = matchByte(chunks, '(');
+    block.slash = matchByte(chunks, '/');
+    block.star = matchByte(chunks, '*');
+    block.blank = matchByte(chunks, ' ') | matchByte(chunks, '\t');
+}
+#else
+static bool vectorizedIndex = false;
+#endif
+
+static void classifyScalar(const char* text, Block& block) {
+    memset(&block, 0, sizeof(block));
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (text[i]) {
+            case '\n': block.newline |= bit; break;
+            case '{': block.openBrace |= bit; break;
+            case '}': block.closeBrace |= bit; break;
+            case '(': block.openParenthesis |= bit; break;
+            case '/': block.slash |= bit; break;
+            case '*': block.star |= bit; break;
+            case ' ': case '\t': block.blank |= bit; break;
+        }
+    }
+}
+
+//A block past the end is padded with zero bytes, which match none of the characters
+static void classify(const char* text, size_t length, Block& block) {
+    char padded[64];
+    if (length < 64) {
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, text, length);
+        text = padded;
+    }
+#if defined(__SSE2__)
+    if (vectorizedIndex) {
+        classifyVectorized(text, block);
+        return;
+    }
+#endif
+    classifyScalar(text, block);
+}
+
+void setVectorized(bool vectorized) {
+#if defined(__SSE2__)
+    vectorizedIndex = vectorized;
+#endif
+}
+
+bool isVectorized() {
+    return vectorizedIndex;
+}
+
+//A line starts at the first byte and after every newline that isn't the last byte
+void findLineStarts(const char* buffer, size_t size, std::vector<int>& lineStarts) {
+    if (size == 0)
+        return;
+    lineStarts.push_back(0);
+    Block block;
+    for (size_t base = 0; base < size; base += 64) {
+        classify(buffer + base, std::min((size_t)64, size - base), block);
+        for (uint64_t newlines = block.newline; newlines != 0; newlines &= newlines - 1) {
+            size_t position = base + __builtin_ctzll(newlines);
+            if (position + 1 < size)
+                lineStarts.push_back(position + 1);
+        }
+    }
+}
+
+//The line being built up as its bytes go by, positions are from the start of the buffer
+struct LineState {
+    size_t start;
+    long firstNonBlank;
+    long lastOpenEnd;
+    long lastCloseEnd;
+    Line line;
+    void reset(size_t lineStart) {
+        this->start = lineStart;
+        this->firstNonBlank = -1;
+        this->lastOpenEnd = -1;
+        this->lastCloseEnd = -1;
+        memset(&this->line, 0, sizeof(this->line));
+    }
+};
+
+static Line finishLine(const char* buffer, size_t end, LineState& state) {
+    Line line = state.line;
+    //Trimming only takes off spaces and tabs, so the line starts at its first other byte
+    long first = state.firstNonBlank;
+    line.startsAsComment = (first >= 0) && ((buffer[first] == '*') ||
+            ((buffer[first] == '/') && (first + 1 < end) && (buffer[first+1] == '/')));
+    //The masks mark where each two character marker ends
+    line.lastCommentOpen = (state.lastOpenEnd >= 0) ? state.lastOpenEnd - 1 - state.start : -1;
+    line.lastCommentClose = (state.lastCloseEnd >= 0) ? state.lastCloseEnd - 1 - state.start : -1;
+    return line;
+}
+
+//Add the lines after those already in lines, up to lastLine, the whole lines are scanned
+//on their own so they can be done a chunk at a time
+void scanLines(const char* buffer, size_t size, const int* lineStarts, int lineCount,
+        int lastLine, std::vector<Line>& lines) {
+    int current = lines.size();
+    lastLine = std::min(lastLine, lineCount);
+    if (current >= lastLine)
+        return;
+    size_t start = lineStarts[current];
+    size_t end = (lastLine < lineCount) ? lineStarts[lastLine] : size;
+    LineState state;
+    state.reset(start);
+    //Markers can straddle two blocks, so carry whether the last byte was a '/' or '*'
+    uint64_t slashCarry = 0;
+    uint64_t starCarry = 0;
+    Block block;
+    for (size_t base = start; base < end; base += 64) {
+        size_t length = std::min((size_t)64, end - base);
+        classify(buffer + base, length, block);
+        uint64_t valid = (length == 64) ? ~(uint64_t)0 : (((uint64_t)1 << length) - 1);
+        uint64_t afterSlash = (block.slash << 1) | slashCarry;
+        uint64_t afterStar = (block.star << 1) | starCarry;
+        uint64_t lineComment = block.slash & afterSlash;
+        uint64_t commentOpen = block.star & afterSlash;
+        uint64_t commentClose = block.slash & afterStar;
+        uint64_t nonBlank = ~block.blank & ~block.newline & valid;
+        slashCarry = block.slash >> 63;
+        starCarry = block.star >> 63;
+        //Split the block at each newline, the part up to and including it finishes a line
+        uint64_t remaining = valid;
+        while (remaining != 0) {
+            uint64_t newlines = block.newline & remaining;
+            uint64_t part = remaining;
+            if (newlines != 0) {
+                uint64_t lowest = newlines & (~newlines + 1);
+                part = remaining & (lowest | (lowest - 1));
+            }
+            state.line.openBraces += __builtin_popcountll(block.openBrace & part);
+            state.line.closeBraces += __builtin_popcountll(block.closeBrace & part);
+            state.line.hasParenthesis |= ((block.openParenthesis & part) != 0);
+            state.line.hasLineComment |= ((lineComment & part) != 0);
+            if (commentOpen & part)
+                state.lastOpenEnd = base + 63 - __builtin_clzll(commentOpen & part);
+            if (commentClose & part)
+                state.lastCloseEnd = base + 63 - __builtin_clzll(commentClose & part);
+            if ((state.firstNonBlank < 0) && (nonBlank & part))
+                state.firstNonBlank = base + __builtin_ctzll(nonBlank & part);
+            remaining &= ~part;
+            if (newlines != 0) {
+                size_t newline = base + 63 - __builtin_clzll(part);
+                lines.push_back(finishLine(buffer, newline, state));
+                current++;
+                state.reset(newline + 1);
+            }
+        }
+    }
+    //The last line of the file may not end in a newline
+    if (current < lastLine)
+        lines.push_back(finishLine(buffer, end, state));
+}
+
+} //namespace StructuralIndex
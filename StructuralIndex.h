@@ -0,0 +1,67 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   StructuralIndex.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#ifndef STRUCTURALINDEX_H
+#define STRUCTURALINDEX_H
+
+#include <stddef.h>
+#include <vector>
+
+//Finds the characters JavaReader's index looks at (newlines, braces, parentheses,
+//comment markers and blanks) 64 bytes at a time, as bitmasks, with SSE2 where the
+//compiler has it and a byte loop otherwise. Both give the same masks, so the same lines.
+namespace StructuralIndex {
+
+    //What the index needs to know about one line, without reading it again
+    struct Line {
+        int openBraces;
+        int closeBraces;
+        bool hasParenthesis;
+        bool hasLineComment;
+        //The line trimmed starts with "*" or "//", so its braces aren't counted
+        bool startsAsComment;
+        //Columns where the last "/*" and the last "*/" on the line start, -1 if none
+        int lastCommentOpen;
+        int lastCommentClose;
+    };
+
+    void findLineStarts(const char* buffer, size_t size, std::vector<int>& lineStarts);
+    
+    void scanLines(const char* buffer, size_t size, const int* lineStarts, int lineCount,
+            int lastLine, std::vector<Line>& lines);
+    
+    void setVectorized(bool vectorized);
+    
+    bool isVectorized();
+
+} //namespace StructuralIndex
+
+#endif /* STRUCTURALINDEX_H */
@@ -0,0 +1,124 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   Symbols.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#include "Symbols.h"
+#include <deque>
+#include <pthread.h>
+#include <unordered_map>
+
+namespace Symbols {
+
+//The table shared by every thread, lookups of known names only take the read lock
+class SymbolTable {
+public:
+    SymbolTable() {
+        pthread_rwlock_init(&this->lock, NULL);
+        //Same order as Symbols::Predefined
+        const char* predefined[] = { "", "String literal", "Integer literal", "Double literal",
+                "null", "Static Class", "String", "String[]", "int", "function", "expression", "Process",
+                "unlisted type" };
+        for (const char* name : predefined)
+            this->add(name);
+    }
+    ~SymbolTable() {
+        pthread_rwlock_destroy(&this->lock);
+    }
+    Symbol intern(const std::string& name) {
+        pthread_rwlock_rdlock(&this->lock);
+        std::unordered_map<std::string, Symbol>::const_iterator found = this->symbols.find(name);
+        bool exists = (found != this->symbols.end());
+        Symbol symbol = exists ? found->second : Empty;
+        pthread_rwlock_unlock(&this->lock);
+        if (exists)
+            return symbol;
+        //Another thread may have added it in between, add() checks again
+        pthread_rwlock_wrlock(&this->lock);
+        symbol = this->add(name);
+        pthread_rwlock_unlock(&this->lock);
+        return symbol;
+    }
+    Symbol find(const std::string& name) {
+        pthread_rwlock_rdlock(&this->lock);
+        std::unordered_map<std::string, Symbol>::const_iterator found = this->symbols.find(name);
+        Symbol symbol = (found != this->symbols.end()) ? found->second : Empty;
+        pthread_rwlock_unlock(&this->lock);
+        return symbol;
+    }
+    const std::string& getName(Symbol symbol) {
+        //Names never move once added, so the reference stays good after unlocking
+        pthread_rwlock_rdlock(&this->lock);
+        const std::string& name = (symbol < this->names.size()) ? this->names[symbol] : this->names[Empty];
+        pthread_rwlock_unlock(&this->lock);
+        return name;
+    }
+private:
+    Symbol add(const std::string& name) {
+        std::unordered_map<std::string, Symbol>::const_iterator found = this->symbols.find(name);
+        if (found != this->symbols.end())
+            return found->second;
+        Symbol symbol = this->names.size();
+        this->names.push_back(name);
+        this->symbols[name] = symbol;
+        return symbol;
+    }
+    pthread_rwlock_t lock;
+    std::unordered_map<std::string, Symbol> symbols;
+    std::deque<std::string> names;
+};
+
+static SymbolTable& getTable() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol intern(const std::string& name) {
+    return getTable().intern(name);
+}
+
+//Like intern, but names that were never seen come back as Empty
+Symbol find(const std::string& name) {
+    return getTable().find(name);
+}
+
+const std::string& getName(Symbol symbol) {
+    return getTable().getName(symbol);
+}
+
+bool isLiteral(Symbol symbol) {
+    return (symbol == StringLiteral) || (symbol == IntegerLiteral) || (symbol == DoubleLiteral);
+}
+
+//For printing tables in the same order as when they were keyed by name
+bool lessByName(Symbol left, Symbol right) {
+    return getName(left) < getName(right);
+}
+
+} //namespace Symbols
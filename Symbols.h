@@ -0,0 +1,74 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   Symbols.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <string>
+
+//Type names and identifiers are interned into small integer ids
+//so they can be compared and hashed cheaply, names come back at print time
+typedef unsigned int Symbol;
+
+namespace Symbols {
+
+    //Names the parser compares against, interned in this order up front
+    enum Predefined : Symbol {
+        Empty = 0,
+        StringLiteral,
+        IntegerLiteral,
+        DoubleLiteral,
+        Null,
+        StaticClass,
+        String,
+        StringArray,
+        Int,
+        Function,
+        Expression,
+        Process,
+        //Stands in for a type name that was found but never interned, see JavaParser::typeSymbol
+        Unlisted,
+        PredefinedCount
+    };
+
+    Symbol intern(const std::string& name);
+    
+    Symbol find(const std::string& name);
+    
+    const std::string& getName(Symbol symbol);
+    
+    bool isLiteral(Symbol symbol);
+    
+    bool lessByName(Symbol left, Symbol right);
+
+} //namespace Symbols
+
+#endif /* SYMBOLS_H */
@@ -0,0 +1,410 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   TrigramIndex.cpp
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 3:16 AM
+ */
+
+#include "TrigramIndex.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include "FilePrefetcher.h"
+#include "ProjectSnapshot.h"
+
+static const char indexMagic[8] = {'R', 'S', 'T', 'R', 'I', 'G', '0', '1'};
+
+//Pad the output up to a multiple of alignment so what follows can be read in place
+static void pad(std::ofstream& output, uint64_t& offset, uint64_t alignment) {
+    while (offset % alignment) {
+        output.put('\0');
+        offset++;
+    }
+}
+
+//Postings are file numbers in order, stored as the gap from the last in 7 bit groups
+static void writeVarint(std::string& output, uint32_t value) {
+    while (value >= 0x80) {
+        output.push_back((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    output.push_back((char)value);
+}
+
+//A file's modified time in nanoseconds, or false if it can't be looked at
+static bool fileStatus(const std::string& filePath, uint64_t& modifiedTime, uint64_t& fileSize) {
+    struct stat status;
+    if (stat(filePath.c_str(), &status) != 0)
+        return false;
+    modifiedTime = (uint64_t)status.st_mtim.tv_sec * 1000000000ull + status.st_mtim.tv_nsec;
+    fileSize = status.st_size;
+    return true;
+}
+
+TrigramIndex::TrigramIndex(const std::string& indexPath) : data(NULL), size(0), header(NULL),
+        files(NULL), trigrams(NULL) {
+    int fd = open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    struct stat status;
+    if ((fstat(fd, &status) == 0) && (status.st_size >= sizeof(Header))) {
+        void* mapped = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            this->data = (const char*)mapped;
+            this->size = status.st_size;
+        }
+    }
+    //The mapping stays good after the descriptor is closed
+    close(fd);
+    if (this->data == NULL)
+        return;
+    this->header = (const Header*)this->data;
+    this->files = (const FileEntry*)(this->data + this->header->filesOffset);
+    this->trigrams = (const TrigramEntry*)(this->data + this->header->trigramsOffset);
+    if (!this->validate()) {
+        munmap((void*)this->data, this->size);
+        this->data = NULL;
+        this->header = NULL;
+        this->files = NULL;
+        this->trigrams = NULL;
+    }
+}
+
+TrigramIndex::~TrigramIndex() {
+    if (this->data != NULL)
+        munmap((void*)this->data, this->size);
+}
+
+bool TrigramIndex::isOpen() const {
+    return (this->data != NULL);
+}
+
+int TrigramIndex::getFileCount() const {
+    return this->isOpen() ? this->header->fileCount : 0;
+}
+
+std::string TrigramIndex::getFilePath(uint32_t index) const {
+    const FileEntry& entry = this->files[index];
+    return std::string(this->data + entry.pathOffset, entry.pathLength);
+}
+
+//Binary search the trigram table, which was written in order
+const TrigramIndex::TrigramEntry* TrigramIndex::findTrigram(uint32_t trigram) const {
+    const TrigramEntry* end = this->trigrams + this->header->trigramCount;
+    const TrigramEntry* entry = std::lower_bound(this->trigrams, end, trigram,
+            [](const TrigramEntry& entry, uint32_t trigram) { return entry.trigram < trigram; });
+    return ((entry != end) && (entry->trigram == trigram)) ? entry : NULL;
+}
+
+//Decode a posting list, false if it runs past its bytes or names a file that isn't there
+bool TrigramIndex::readPostings(const TrigramEntry& entry, std::vector<uint32_t>& files) const {
+    files.clear();
+    files.reserve(entry.fileCount);
+    const unsigned char* position = (const unsigned char*)this->data + entry.postingsOffset;
+    const unsigned char* end = position + entry.postingsLength;
+    uint32_t file = 0;
+    for (uint32_t i = 0; i < entry.fileCount; i++) {
+        uint32_t gap = 0;
+        for (int shift = 0; ; shift += 7) {
+            if ((position == end) || (shift > 28))
+                return false;
+            unsigned char byte = *position++;
+            gap |= (uint32_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        file += gap;
+        if (file >= this->header->fileCount)
+            return false;
+        files.push_back(file);
+    }
+    return true;
+}
+
+//Check everything the tables point at is inside the mapping, once, so lookups don't have to
+bool TrigramIndex::validate() const {
+    if (memcmp(this->header->magic, indexMagic, sizeof(indexMagic)) != 0)
+        return false;
+    if (this->header->indexSize != this->size)
+        return false;
+    uint64_t filesSize = (uint64_t)this->header->fileCount * sizeof(FileEntry);
+    if ((this->header->filesOffset % alignof(FileEntry)) || (this->header->filesOffset > this->size)
+            || (filesSize > this->size - this->header->filesOffset))
+        return false;
+    uint64_t trigramsSize = (uint64_t)this->header->trigramCount * sizeof(TrigramEntry);
+    if ((this->header->trigramsOffset % alignof(TrigramEntry)) || (this->header->trigramsOffset > this->size)
+            || (trigramsSize > this->size - this->header->trigramsOffset))
+        return false;
+    for (uint32_t i = 0; i < this->header->fileCount; i++) {
+        const FileEntry& entry = this->files[i];
+        if ((entry.pathOffset > this->size) || (entry.pathLength > this->size - entry.pathOffset))
+            return false;
+    }
+    for (uint32_t i = 0; i < this->header->trigramCount; i++) {
+        const TrigramEntry& entry = this->trigrams[i];
+        if ((entry.postingsOffset > this->size) || (entry.postingsLength > this->size - entry.postingsOffset))
+            return false;
+        if ((i > 0) && (this->trigrams[i-1].trigram >= entry.trigram))
+            return false;
+    }
+    return true;
+}
+
+//Every distinct trigram of the text once, in order, leaving out the ones that span a line
+void TrigramIndex::findTrigrams(const std::string& text, std::vector<uint32_t>& trigrams) {
+    trigrams.clear();
+    for (size_t i = 0; i + 2 < text.size(); i++) {
+        unsigned char first = text[i];
+        unsigned char second = text[i+1];
+        unsigned char third = text[i+2];
+        if ((first == '\n') || (second == '\n') || (third == '\n'))
+            continue;
+        trigrams.push_back((uint32_t)first << 16 | (uint32_t)second << 8 | third);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+//The lines of the project containing the pattern, by file path relative to the project
+//Only the files holding every trigram of the pattern are read, a pattern too short to have
+//a trigram has to read them all. Files whose time or size changed since the index was made
+//can't go by their postings, so they're read too and counted in changedCount, but a file
+//added since isn't in it until the index is updated.
+std::map<std::string, std::vector<int>> TrigramIndex::query(const std::string& projectPath,
+        const std::string& pattern, int& readCount, int& changedCount) const {
+    std::map<std::string, std::vector<int>> fileLines;
+    readCount = 0;
+    changedCount = 0;
+    if (!this->isOpen() || pattern.empty() || (pattern.find('\n') != std::string::npos))
+        return fileLines;
+    //Postings are only good for the files as they were indexed
+    std::vector<uint32_t> changed;
+    for (uint32_t i = 0; i < this->header->fileCount; i++) {
+        uint64_t modifiedTime = 0;
+        uint64_t fileSize = 0;
+        if (!fileStatus(projectPath + "/" + this->getFilePath(i), modifiedTime, fileSize) ||
+                (modifiedTime != this->files[i].modifiedTime) || (fileSize != this->files[i].fileSize))
+            changed.push_back(i);
+    }
+    changedCount = changed.size();
+    //A trigram no file had leaves only the changed files
+    std::vector<uint32_t> patternTrigrams;
+    findTrigrams(pattern, patternTrigrams);
+    std::vector<const TrigramEntry*> entries;
+    bool unindexed = false;
+    for (uint32_t trigram : patternTrigrams) {
+        const TrigramEntry* entry = this->findTrigram(trigram);
+        if (entry == NULL) {
+            unindexed = true;
+            break;
+        }
+        entries.push_back(entry);
+    }
+    //Intersect from the rarest trigram up, so the candidate list only shrinks
+    std::sort(entries.begin(), entries.end(), [](const TrigramEntry* first, const TrigramEntry* second) {
+        return first->fileCount < second->fileCount;
+    });
+    std::vector<uint32_t> candidates;
+    if (entries.empty() && !unindexed) {
+        for (uint32_t i = 0; i < this->header->fileCount; i++)
+            candidates.push_back(i);
+    }
+    std::vector<uint32_t> postings;
+    std::vector<uint32_t> intersection;
+    for (size_t i = 0; !unindexed && (i < entries.size()); i++) {
+        if (!this->readPostings(*entries[i], postings))
+            return fileLines;
+        if (i == 0) {
+            candidates.swap(postings);
+            continue;
+        }
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), postings.begin(), postings.end(),
+                std::back_inserter(intersection));
+        candidates.swap(intersection);
+        if (candidates.empty())
+            break;
+    }
+    intersection.clear();
+    std::set_union(candidates.begin(), candidates.end(), changed.begin(), changed.end(),
+            std::back_inserter(intersection));
+    candidates.swap(intersection);
+    //The trigrams only narrow it down, the lines have to be checked for the whole pattern
+    for (uint32_t file : candidates) {
+        std::string filePath = this->getFilePath(file);
+        std::string contents = FilePrefetcher::readFile(projectPath + "/" + filePath);
+        readCount++;
+        int lineNumber = 1;
+        size_t lineStart = 0;
+        size_t match = contents.find(pattern);
+        while (match != std::string::npos) {
+            for (size_t i = lineStart; i < match; i++) {
+                if (contents[i] == '\n') {
+                    lineNumber++;
+                    lineStart = i + 1;
+                }
+            }
+            fileLines[filePath].push_back(lineNumber);
+            //Grep gives a line once however many times it matches
+            size_t lineEnd = contents.find('\n', match);
+            if (lineEnd == std::string::npos)
+                break;
+            match = contents.find(pattern, lineEnd + 1);
+        }
+    }
+    return fileLines;
+}
+
+//Index every .java file under the project, keeping the postings of files unchanged since the last index
+//It's written next to the destination and renamed over it, so an index being read is never half written
+bool TrigramIndex::update(const std::string& projectPath, const std::string& indexPath, int& fileCount,
+        int& readCount) {
+    std::vector<std::string> javaFiles;
+    ProjectSnapshot::findJavaFiles(projectPath, "", javaFiles);
+    std::sort(javaFiles.begin(), javaFiles.end());
+    fileCount = javaFiles.size();
+    readCount = 0;
+    std::vector<FileEntry> files(javaFiles.size());
+    for (size_t i = 0; i < javaFiles.size(); i++) {
+        memset(&files[i], 0, sizeof(FileEntry));
+        fileStatus(projectPath + "/" + javaFiles[i], files[i].modifiedTime, files[i].fileSize);
+    }
+    //Old file numbers of unchanged files map to their new ones, the rest to -1
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+    std::vector<bool> indexed(javaFiles.size(), false);
+    TrigramIndex previous(indexPath);
+    if (previous.isOpen()) {
+        std::vector<int64_t> renumbered(previous.header->fileCount, -1);
+        size_t next = 0;
+        for (uint32_t i = 0; i < previous.header->fileCount; i++) {
+            std::string filePath = previous.getFilePath(i);
+            while ((next < javaFiles.size()) && (javaFiles[next] < filePath))
+                next++;
+            if ((next == javaFiles.size()) || (javaFiles[next] != filePath))
+                continue;
+            const FileEntry& entry = previous.files[i];
+            if ((entry.modifiedTime == files[next].modifiedTime) && (entry.fileSize == files[next].fileSize)) {
+                renumbered[i] = next;
+                indexed[next] = true;
+            }
+        }
+        std::vector<uint32_t> oldFiles;
+        for (uint32_t i = 0; i < previous.header->trigramCount; i++) {
+            const TrigramEntry& entry = previous.trigrams[i];
+            if (!previous.readPostings(entry, oldFiles)) {
+                //A damaged list means the whole old index can't be trusted, so read everything
+                postings.clear();
+                std::fill(indexed.begin(), indexed.end(), false);
+                break;
+            }
+            for (uint32_t oldFile : oldFiles)
+                if (renumbered[oldFile] >= 0)
+                    postings[entry.trigram].push_back(renumbered[oldFile]);
+        }
+    }
+    std::vector<uint32_t> fileTrigrams;
+    for (size_t i = 0; i < javaFiles.size(); i++) {
+        if (indexed[i])
+            continue;
+        std::string contents = FilePrefetcher::readFile(projectPath + "/" + javaFiles[i]);
+        readCount++;
+        findTrigrams(contents, fileTrigrams);
+        for (uint32_t trigram : fileTrigrams)
+            postings[trigram].push_back(i);
+    }
+    std::vector<uint32_t> trigramOrder;
+    trigramOrder.reserve(postings.size());
+    for (const std::pair<const uint32_t, std::vector<uint32_t>>& posting : postings)
+        if (!posting.second.empty())
+            trigramOrder.push_back(posting.first);
+    std::sort(trigramOrder.begin(), trigramOrder.end());
+    
+    std::string temporaryPath = indexPath + ".tmp";
+    std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!output)
+        return false;
+    //The header is written again at the end, once the tables' offsets are known
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.fileCount = javaFiles.size();
+    header.trigramCount = trigramOrder.size();
+    output.write((const char*)&header, sizeof(header));
+    uint64_t offset = sizeof(header);
+    for (size_t i = 0; i < javaFiles.size(); i++) {
+        files[i].pathOffset = offset;
+        files[i].pathLength = javaFiles[i].size();
+        output.write(javaFiles[i].data(), javaFiles[i].size());
+        offset += javaFiles[i].size();
+    }
+    std::vector<TrigramEntry> trigrams;
+    trigrams.reserve(trigramOrder.size());
+    std::string encoded;
+    for (uint32_t trigram : trigramOrder) {
+        std::vector<uint32_t>& fileList = postings[trigram];
+        //Unchanged files keep their order, but new ones land after them
+        std::sort(fileList.begin(), fileList.end());
+        encoded.clear();
+        uint32_t last = 0;
+        for (uint32_t file : fileList) {
+            writeVarint(encoded, file - last);
+            last = file;
+        }
+        TrigramEntry entry;
+        entry.trigram = trigram;
+        entry.fileCount = fileList.size();
+        entry.postingsOffset = offset;
+        entry.postingsLength = encoded.size();
+        output.write(encoded.data(), encoded.size());
+        offset += encoded.size();
+        trigrams.push_back(entry);
+    }
+    pad(output, offset, alignof(FileEntry));
+    header.filesOffset = offset;
+    output.write((const char*)files.data(), files.size() * sizeof(FileEntry));
+    offset += files.size() * sizeof(FileEntry);
+    pad(output, offset, alignof(TrigramEntry));
+    header.trigramsOffset = offset;
+    output.write((const char*)trigrams.data(), trigrams.size() * sizeof(TrigramEntry));
+    offset += trigrams.size() * sizeof(TrigramEntry);
+    header.indexSize = offset;
+    output.seekp(0);
+    output.write((const char*)&header, sizeof(header));
+    output.close();
+    if (!output || (rename(temporaryPath.c_str(), indexPath.c_str()) != 0)) {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
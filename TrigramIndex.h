@@ -0,0 +1,93 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   TrigramIndex.h
+ * Author: William Wickerson
+ *
+ * Created on October 19, 2026, 3:16 AM
+ */
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+//For every three byte sequence in the project's .java files, the files it appears in.
+//A query only reads the files that have every trigram of the pattern, so finding the
+//lines of a new sink doesn't take another grep over the whole tree. Updating an index
+//only reads the files that were added or changed since, the rest keep their postings.
+class TrigramIndex {
+public:
+    TrigramIndex(const std::string& indexPath);
+    ~TrigramIndex();
+    bool isOpen() const;
+    int getFileCount() const;
+    std::map<std::string, std::vector<int>> query(const std::string& projectPath, const std::string& pattern,
+            int& readCount, int& changedCount) const;
+    static bool update(const std::string& projectPath, const std::string& indexPath, int& fileCount,
+            int& readCount);
+private:
+    //Laid out as stored, the header starts the file and the trigram table ends it
+    struct Header {
+        char magic[8];
+        uint32_t fileCount;
+        uint32_t trigramCount;
+        uint64_t filesOffset;
+        uint64_t trigramsOffset;
+        uint64_t indexSize;
+    };
+    //Files are in path order, a file's position is its number in the postings
+    struct FileEntry {
+        uint64_t pathOffset;
+        uint64_t modifiedTime;
+        uint64_t fileSize;
+        uint32_t pathLength;
+        uint32_t reserved;
+    };
+    //Trigrams are in order, each with its file numbers as varint deltas
+    struct TrigramEntry {
+        uint32_t trigram;
+        uint32_t fileCount;
+        uint64_t postingsOffset;
+        uint64_t postingsLength;
+    };
+    TrigramIndex(const TrigramIndex&);
+    TrigramIndex& operator=(const TrigramIndex&);
+    bool validate() const;
+    std::string getFilePath(uint32_t index) const;
+    const TrigramEntry* findTrigram(uint32_t trigram) const;
+    bool readPostings(const TrigramEntry& entry, std::vector<uint32_t>& files) const;
+    static void findTrigrams(const std::string& text, std::vector<uint32_t>& trigrams);
+    const char* data;
+    size_t size;
+    const Header* header;
+    const FileEntry* files;
+    const TrigramEntry* trigrams;
+};
+
+#endif /* TRIGRAMINDEX_H */
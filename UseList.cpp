@@ -0,0 +1,94 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   UseList.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#include "UseList.h"
+
+UseList::UseList() : memoryLimit(0), memoryUsed(0), useCount(0), spillFile(NULL) {};
+
+UseList::~UseList() {
+    //tmpfile() removes the file itself once it is closed
+    if (this->spillFile != NULL)
+        fclose(this->spillFile);
+}
+
+//A limit of 0 keeps every usage in memory
+void UseList::setMemoryLimit(size_t bytes) {
+    this->memoryLimit = bytes;
+}
+
+void UseList::push_back(const std::string& usage) {
+    this->uses.push_back(usage);
+    this->memoryUsed += usage.capacity() + sizeof(std::string);
+    this->useCount++;
+    //Once over the limit, move everything held so far out to disk
+    if ((this->memoryLimit > 0) && (this->memoryUsed > this->memoryLimit))
+        this->spill();
+}
+
+size_t UseList::size() const {
+    return this->useCount;
+}
+
+void UseList::spill() {
+    //Open the temporary file the first time we need it
+    if (this->spillFile == NULL)
+        this->spillFile = tmpfile();
+    //If there is no temporary file available, keep the uses in memory
+    if (this->spillFile == NULL)
+        return;
+    //Usages contain newlines, so write each one with its length in front
+    fseek(this->spillFile, 0, SEEK_END);
+    for (const std::string& usage : this->uses) {
+        size_t length = usage.size();
+        fwrite(&length, sizeof(length), 1, this->spillFile);
+        fwrite(usage.data(), 1, length, this->spillFile);
+    }
+    //Swap with an empty vector so the capacity is actually released
+    std::vector<std::string>().swap(this->uses);
+    this->memoryUsed = 0;
+}
+
+void UseList::write(std::ostream& out) {
+    //Spilled usages came first, so replay the file before the memory ones
+    if (this->spillFile != NULL) {
+        rewind(this->spillFile);
+        size_t length;
+        std::string usage;
+        while (fread(&length, sizeof(length), 1, this->spillFile) == 1) {
+            usage.resize(length);
+            if (length > 0 && fread(&usage[0], 1, length, this->spillFile) != length)
+                break;
+            out << usage << std::endl;
+        }
+    }
+    for (const std::string& usage : this->uses)
+        out << usage << std::endl;
+}
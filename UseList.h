@@ -0,0 +1,60 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   UseList.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef USELIST_H
+#define USELIST_H
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//List of usage strings that spills to a temporary file past a memory limit
+class UseList {
+public:
+    UseList();
+    ~UseList();
+    void setMemoryLimit(size_t bytes);
+    void push_back(const std::string& usage);
+    size_t size() const;
+    void write(std::ostream& out);
+private:
+    UseList(const UseList&);
+    UseList& operator=(const UseList&);
+    void spill();
+    std::vector<std::string> uses;
+    size_t memoryLimit;
+    size_t memoryUsed;
+    size_t useCount;
+    FILE* spillFile;
+};
+
+#endif /* USELIST_H */
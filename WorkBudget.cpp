@@ -0,0 +1,68 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   WorkBudget.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 9:20 PM
+ */
+
+#include "WorkBudget.h"
+
+WorkBudget::WorkBudget(long maxSteps, double maxSeconds) : maxSteps(maxSteps),
+        maxSeconds(maxSeconds), steps(0), exhausted(false),
+        startTime(std::chrono::steady_clock::now()) {};
+
+//Begin again with the whole budget, for the next candidate
+void WorkBudget::start() {
+    this->steps = 0;
+    this->exhausted = false;
+    this->startTime = std::chrono::steady_clock::now();
+}
+
+//Count one step of work, false once either limit has been passed
+bool WorkBudget::spend() {
+    if (this->exhausted)
+        return false;
+    long taken = ++this->steps;
+    if ((this->maxSteps > 0) && (taken > this->maxSteps))
+        this->exhausted = true;
+    else if ((this->maxSeconds > 0) && (std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - this->startTime).count() > this->maxSeconds))
+        this->exhausted = true;
+    return !this->exhausted;
+}
+
+bool WorkBudget::isExhausted() const {
+    return this->exhausted;
+}
+
+bool WorkBudget::isLimited() const {
+    return (this->maxSteps > 0) || (this->maxSeconds > 0);
+}
+
+long WorkBudget::getSteps() const {
+    return this->steps;
+}
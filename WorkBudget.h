@@ -0,0 +1,58 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   WorkBudget.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 9:20 PM
+ */
+
+#ifndef WORKBUDGET_H
+#define WORKBUDGET_H
+
+#include <atomic>
+#include <chrono>
+
+//Bounds the steps and wall time spent on a piece of work, 0 means no limit
+//Once it runs out it stays out, so every caller up the recursion sees it
+class WorkBudget {
+public:
+    WorkBudget(long maxSteps, double maxSeconds);
+    void start();
+    bool spend();
+    bool isExhausted() const;
+    bool isLimited() const;
+    long getSteps() const;
+private:
+    WorkBudget(const WorkBudget&);
+    WorkBudget& operator=(const WorkBudget&);
+    long maxSteps;
+    double maxSeconds;
+    std::atomic<long> steps;
+    std::atomic<bool> exhausted;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif /* WORKBUDGET_H */
@@ -0,0 +1,290 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ZipArchive.cpp
+ * Author: William Wickerson
+ * 
+ * Created on October 18, 2026, 8:52 PM
+ */
+
+#include "ZipArchive.h"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+//Zip records are little endian no matter the machine
+static uint16_t read16(const std::string& data, size_t offset) {
+    return (uint16_t)((unsigned char)data[offset] | ((unsigned char)data[offset+1] << 8));
+}
+
+static uint32_t read32(const std::string& data, size_t offset) {
+    return (uint32_t)read16(data, offset) | ((uint32_t)read16(data, offset + 2) << 16);
+}
+
+static uint64_t read64(const std::string& data, size_t offset) {
+    return (uint64_t)read32(data, offset) | ((uint64_t)read32(data, offset + 4) << 32);
+}
+
+//Record signatures and fixed sizes from the zip specification
+static const uint32_t localHeaderSignature = 0x04034b50;
+static const uint32_t centralHeaderSignature = 0x02014b50;
+static const uint32_t endSignature = 0x06054b50;
+static const uint32_t zip64EndSignature = 0x06064b50;
+static const uint32_t zip64LocatorSignature = 0x07064b50;
+static const size_t localHeaderSize = 30;
+static const size_t centralHeaderSize = 46;
+static const size_t endSize = 22;
+static const size_t zip64LocatorSize = 20;
+static const size_t zip64EndSize = 56;
+static const uint16_t storedMethod = 0;
+static const uint16_t deflatedMethod = 8;
+
+//Archive names that may be followed by "!/" and a member name
+static const char* archiveExtensions[] = { ".srcjar", ".zip", ".jar" };
+
+ZipArchive::ZipArchive(const std::string& archivePath) : archivePath(archivePath), archiveSize(0) {
+    this->fd = open(archivePath.c_str(), O_RDONLY);
+    if (this->fd < 0)
+        return;
+    struct stat archiveStat;
+    if ((fstat(this->fd, &archiveStat) == 0) && this->readDirectory(archiveStat.st_size))
+        return;
+    //Anything that isn't a readable zip is treated like a missing file
+    close(this->fd);
+    this->fd = -1;
+    this->members.clear();
+}
+
+ZipArchive::~ZipArchive() {
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+bool ZipArchive::isOpen() const {
+    return (this->fd >= 0);
+}
+
+const std::string& ZipArchive::getPath() const {
+    return this->archivePath;
+}
+
+std::vector<std::string> ZipArchive::getMemberNames() const {
+    std::vector<std::string> memberNames;
+    for (auto const& member : this->members)
+        memberNames.push_back(member.first);
+    return memberNames;
+}
+
+//Inflate a single member into contents, false if it's missing or corrupt
+bool ZipArchive::readMember(const std::string& memberName, std::string& contents) const {
+    contents.clear();
+    std::map<std::string, Member>::const_iterator found = this->members.find(memberName);
+    if (found == this->members.end())
+        return false;
+    const Member& member = found->second;
+    //The local header repeats the name and extra field, their lengths can differ from the central one
+    std::string header;
+    if (!this->readAt(member.headerOffset, localHeaderSize, header) || (read32(header, 0) != localHeaderSignature))
+        return false;
+    uint64_t dataOffset = member.headerOffset + localHeaderSize + read16(header, 26) + read16(header, 28);
+    if (member.method == storedMethod)
+        return this->readAt(dataOffset, member.size, contents);
+    if (member.method != deflatedMethod)
+        return false;
+    //Deflated data is inflated a block at a time so the compressed copy is never whole in memory
+    z_stream stream = z_stream();
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+    contents.reserve(member.size);
+    std::string input;
+    char output[65536];
+    uint64_t remaining = member.compressedSize;
+    int status = Z_OK;
+    while (status == Z_OK) {
+        if (stream.avail_in == 0) {
+            size_t length = std::min<uint64_t>(remaining, sizeof(output));
+            if ((length == 0) || !this->readAt(dataOffset, length, input))
+                break;
+            dataOffset += length;
+            remaining -= length;
+            stream.next_in = (Bytef*)&input[0];
+            stream.avail_in = length;
+        }
+        stream.next_out = (Bytef*)output;
+        stream.avail_out = sizeof(output);
+        status = inflate(&stream, Z_NO_FLUSH);
+        contents.append(output, sizeof(output) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        contents.clear();
+        return false;
+    }
+    return true;
+}
+
+//Split "archive.srcjar!/pkg/Foo.java" into its archive and member, false for plain files
+bool ZipArchive::splitPath(const std::string& filePath, std::string& archivePath, std::string& memberName) {
+    for (size_t separator = filePath.find("!/"); separator != std::string::npos;
+            separator = filePath.find("!/", separator + 1)) {
+        for (const char* extension : archiveExtensions) {
+            size_t length = std::char_traits<char>::length(extension);
+            if ((separator >= length) && !filePath.compare(separator - length, length, extension)) {
+                archivePath = filePath.substr(0, separator);
+                memberName = filePath.substr(separator + 2);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//Read an archive member by its qualified path, keeping the last few archives open
+//grep lists every match of an archive together, so a few is enough to avoid reopening
+bool ZipArchive::readFile(const std::string& filePath, std::string& contents) {
+    static const size_t openLimit = 4;
+    static std::mutex openLock;
+    static std::deque<std::shared_ptr<ZipArchive>> openArchives;
+    std::string archivePath;
+    std::string memberName;
+    if (!ZipArchive::splitPath(filePath, archivePath, memberName))
+        return false;
+    std::shared_ptr<ZipArchive> archive;
+    {
+        std::lock_guard<std::mutex> guard(openLock);
+        for (const std::shared_ptr<ZipArchive>& openArchive : openArchives)
+            if (openArchive->getPath() == archivePath)
+                archive = openArchive;
+        if (!archive) {
+            archive.reset(new ZipArchive(archivePath));
+            openArchives.push_back(archive);
+            if (openArchives.size() > openLimit)
+                openArchives.pop_front();
+        }
+    }
+    //Reads use pread, so several threads can inflate from one archive at once
+    return archive->readMember(memberName, contents);
+}
+
+//Load the central directory, found through the end record at the back of the file
+bool ZipArchive::readDirectory(uint64_t archiveSize) {
+    this->archiveSize = archiveSize;
+    if (archiveSize < endSize)
+        return false;
+    //The end record is followed by a comment of at most 64K
+    uint64_t tailLength = std::min<uint64_t>(archiveSize, endSize + 0xFFFF);
+    uint64_t tailOffset = archiveSize - tailLength;
+    std::string tail;
+    if (!this->readAt(tailOffset, tailLength, tail))
+        return false;
+    size_t endOffset = std::string::npos;
+    for (size_t i = tailLength - endSize + 1; i-- > 0;) {
+        if (read32(tail, i) == endSignature) {
+            endOffset = i;
+            break;
+        }
+    }
+    if (endOffset == std::string::npos)
+        return false;
+    uint64_t entryCount = read16(tail, endOffset + 10);
+    uint64_t directorySize = read32(tail, endOffset + 12);
+    uint64_t directoryOffset = read32(tail, endOffset + 16);
+    //Large archives keep the real values in a zip64 end record
+    if ((endOffset >= zip64LocatorSize) && (read32(tail, endOffset - zip64LocatorSize) == zip64LocatorSignature)) {
+        std::string zip64End;
+        uint64_t zip64EndOffset = read64(tail, endOffset - zip64LocatorSize + 8);
+        if (!this->readAt(zip64EndOffset, zip64EndSize, zip64End) || (read32(zip64End, 0) != zip64EndSignature))
+            return false;
+        entryCount = read64(zip64End, 32);
+        directorySize = read64(zip64End, 40);
+        directoryOffset = read64(zip64End, 48);
+    }
+    std::string directory;
+    if (!this->readAt(directoryOffset, directorySize, directory))
+        return false;
+    size_t position = 0;
+    for (uint64_t entry = 0; entry < entryCount; entry++) {
+        if ((position + centralHeaderSize > directory.size()) ||
+                (read32(directory, position) != centralHeaderSignature))
+            return false;
+        Member member;
+        member.method = read16(directory, position + 10);
+        member.compressedSize = read32(directory, position + 20);
+        member.size = read32(directory, position + 24);
+        member.headerOffset = read32(directory, position + 42);
+        size_t nameLength = read16(directory, position + 28);
+        size_t extraLength = read16(directory, position + 30);
+        size_t commentLength = read16(directory, position + 32);
+        if (position + centralHeaderSize + nameLength + extraLength + commentLength > directory.size())
+            return false;
+        std::string name = directory.substr(position + centralHeaderSize, nameLength);
+        //Fields that overflowed 32 bits are in the zip64 extra field, in this order
+        size_t extra = position + centralHeaderSize + nameLength;
+        size_t extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd) {
+            uint16_t extraId = read16(directory, extra);
+            size_t extraSize = read16(directory, extra + 2);
+            size_t field = extra + 4;
+            if (extraId == 0x0001) {
+                if ((member.size == 0xFFFFFFFF) && (field + 8 <= extraEnd)) {
+                    member.size = read64(directory, field);
+                    field += 8;
+                }
+                if ((member.compressedSize == 0xFFFFFFFF) && (field + 8 <= extraEnd)) {
+                    member.compressedSize = read64(directory, field);
+                    field += 8;
+                }
+                if ((member.headerOffset == 0xFFFFFFFF) && (field + 8 <= extraEnd))
+                    member.headerOffset = read64(directory, field);
+            }
+            extra += 4 + extraSize;
+        }
+        //Directories end in "/" and have nothing to read
+        if (!name.empty() && (name[name.size() - 1] != '/'))
+            this->members[name] = member;
+        position += centralHeaderSize + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+//Read length bytes at offset, false if the archive is shorter than that
+bool ZipArchive::readAt(uint64_t offset, size_t length, std::string& data) const {
+    if ((offset > this->archiveSize) || (length > this->archiveSize - offset))
+        return false;
+    data.resize(length);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t count = pread(this->fd, &data[done], length - done, offset + done);
+        if (count <= 0)
+            return false;
+        done += count;
+    }
+    return true;
+}
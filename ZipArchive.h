@@ -0,0 +1,69 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2017 William Wickerson.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   ZipArchive.h
+ * Author: William Wickerson
+ *
+ * Created on October 18, 2026, 8:52 PM
+ */
+
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+//Reads members straight out of .srcjar/.zip/.jar archives without extracting them
+//Members are addressed like "archive.srcjar!/pkg/Foo.java"
+class ZipArchive {
+public:
+    ZipArchive(const std::string& archivePath);
+    ~ZipArchive();
+    bool isOpen() const;
+    const std::string& getPath() const;
+    std::vector<std::string> getMemberNames() const;
+    bool readMember(const std::string& memberName, std::string& contents) const;
+    static bool splitPath(const std::string& filePath, std::string& archivePath, std::string& memberName);
+    static bool readFile(const std::string& filePath, std::string& contents);
+private:
+    struct Member {
+        uint16_t method;
+        uint64_t compressedSize;
+        uint64_t size;
+        uint64_t headerOffset;
+    };
+    ZipArchive(const ZipArchive&);
+    ZipArchive& operator=(const ZipArchive&);
+    bool readDirectory(uint64_t archiveSize);
+    bool readAt(uint64_t offset, size_t length, std::string& data) const;
+    std::string archivePath;
+    int fd;
+    uint64_t archiveSize;
+    std::map<std::string, Member> members;
+};
+
+#endif /* ZIPARCHIVE_H */
@@ -31,34 +31,374 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
-#include <iomanip>
+#include <iterator>
+#include <map>
+#include <set>
 
+#include "FilePrefetcher.h"
+#include "FileWatcher.h"
 #include "GrepParser.h"
-#include "JavaParser.h"
+#include "ProgressReporter.h"
+#include "PathFilter.h"
+#include "ProjectSnapshot.h"
+#include "SampleEstimator.h"
+#include "ScanCheckpoint.h"
+#include "ScanSession.h"
+#include "TrigramIndex.h"
 #include "Utility.h"
+#include "ZipArchive.h"
+
+//Number of candidates listed after a scan with --profile-candidates
+static const size_t slowestCandidateCount = 20;
+
+//Convert sizes like "512M" or "2G" into a number of bytes, false if it isn't one
+static bool parseMemorySize(const std::string& size, size_t& bytes) {
+    char* suffix = NULL;
+    double amount = strtod(size.c_str(), &suffix);
+    if ((suffix == size.c_str()) || !(amount >= 0) || (amount > 1e18))
+        return false;
+    switch (*suffix) {
+        case '\0': break;
+        case 'k': case 'K': amount *= 1024.0; break;
+        case 'm': case 'M': amount *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': amount *= 1024.0 * 1024.0 * 1024.0; break;
+        default: return false;
+    }
+    //Only the one letter, "512MB" is as unclear as "512X"
+    if ((*suffix != '\0') && (suffix[1] != '\0'))
+        return false;
+    bytes = (size_t)amount;
+    return true;
+}
+
+//Budgets are a whole number of steps, or a time when given "s" or "ms" like "2s",
+//false if it isn't one
+static bool parseBudget(const std::string& budget, long& steps, double& seconds) {
+    char* suffix = NULL;
+    double amount = strtod(budget.c_str(), &suffix);
+    if ((suffix == budget.c_str()) || !(amount >= 0) || (amount > 1e18))
+        return false;
+    if (!strcmp(suffix, "ms"))
+        seconds = amount / 1000.0;
+    else if (!strcmp(suffix, "s"))
+        seconds = amount;
+    else if ((*suffix == '\0') && (amount == (long)amount))
+        steps = (long)amount;
+    else
+        return false;
+    return true;
+}
+
+//Print the ".exec(" lines of the Java members of an archive in grep's format,
+//so archives can go through the same pipeline as files grep found on disk
+static bool grepArchive(const std::string& archivePath) {
+    ZipArchive archive(archivePath);
+    if (!archive.isOpen())
+        return false;
+    std::string contents;
+    for (const std::string& memberName : archive.getMemberNames()) {
+        if (!Util::endsWith(memberName, ".java") || !archive.readMember(memberName, contents))
+            continue;
+        int lineNumber = 1;
+        size_t lineStart = 0;
+        while (lineStart < contents.size()) {
+            size_t lineEnd = contents.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = contents.size();
+            std::string line = contents.substr(lineStart, lineEnd - lineStart);
+            if (line.find(".exec(") != std::string::npos)
+                std::cout << archivePath << "!/" << memberName << ":" << lineNumber << ":" << line << "\n";
+            lineStart = lineEnd + 1;
+            lineNumber++;
+        }
+    }
+    return true;
+}
+
+static const char* getCategoryName(CandidateResult::Category category) {
+    switch (category) {
+        case CandidateResult::Hardcoded: return "hardcoded";
+        case CandidateResult::Input: return "input";
+        case CandidateResult::Unresolved: return "unresolved (budget)";
+        default: return "other";
+    }
+}
+
+//Print what a rescan changed in one file, uses are matched by category and statement
+//since editing a file moves the line numbers of everything after the edit
+static void printFileDelta(const std::string& filePath, const FileResult* before,
+        const FileResult* after, long milliseconds) {
+    std::multiset<std::pair<int, std::string>> beforeUses;
+    std::multiset<std::pair<int, std::string>> afterUses;
+    if (before != NULL)
+        for (const CandidateResult& candidate : before->candidates)
+            if (candidate.category != CandidateResult::NotRuntime)
+                beforeUses.insert(std::make_pair((int)candidate.category, candidate.statement));
+    if (after != NULL)
+        for (const CandidateResult& candidate : after->candidates)
+            if (candidate.category != CandidateResult::NotRuntime)
+                afterUses.insert(std::make_pair((int)candidate.category, candidate.statement));
+    std::cout << filePath << ": " << beforeUses.size() << " -> " << afterUses.size() << " uses";
+    std::cout << (after == NULL ? " (deleted)" : "") << ", " << milliseconds << " ms" << std::endl;
+    //Whatever is in one and not the other was added or removed
+    std::vector<std::pair<int, std::string>> removed;
+    std::vector<std::pair<int, std::string>> added;
+    std::set_difference(beforeUses.begin(), beforeUses.end(), afterUses.begin(), afterUses.end(),
+            std::back_inserter(removed));
+    std::set_difference(afterUses.begin(), afterUses.end(), beforeUses.begin(), beforeUses.end(),
+            std::back_inserter(added));
+    for (const std::pair<int, std::string>& use : removed)
+        std::cout << "  - " << getCategoryName((CandidateResult::Category)use.first) << ": " << use.second << std::endl;
+    for (const std::pair<int, std::string>& use : added)
+        std::cout << "  + " << getCategoryName((CandidateResult::Category)use.first) << ": " << use.second << std::endl;
+}
+
+//Print the totals after a rescan, and the rows of the type table that moved
+static void printTotalsDelta(const ScanTotals& before, const ScanTotals& after) {
+    std::cout << "Totals: " << after.runtimeCount << " uses: " << after.hardcodedCount << " hardcoded, ";
+    std::cout << after.inputCount << " from function input, ";
+    std::cout << (after.runtimeCount - after.hardcodedCount - after.inputCount - after.unresolvedCount) << " other";
+    if (after.unresolvedCount > 0)
+        std::cout << ", " << after.unresolvedCount << " unresolved (budget)";
+    std::cout << std::endl;
+    std::set<Symbol> types;
+    for (auto const& x : before.typeCounts)
+        types.insert(x.first);
+    for (auto const& x : after.typeCounts)
+        types.insert(x.first);
+    for (Symbol type : types) {
+        std::unordered_map<Symbol,int>::const_iterator beforeCount = before.typeCounts.find(type);
+        std::unordered_map<Symbol,int>::const_iterator afterCount = after.typeCounts.find(type);
+        int oldCount = (beforeCount == before.typeCounts.end()) ? 0 : beforeCount->second;
+        int newCount = (afterCount == after.typeCounts.end()) ? 0 : afterCount->second;
+        if (oldCount == newCount)
+            continue;
+        std::cout << "  " << ((type == Symbols::Empty) ? "(unknown type)" : Symbols::getName(type));
+        std::cout << ": " << oldCount << " -> " << newCount << std::endl;
+    }
+}
+
+//The project's .scannerignore comes first so rules from the command line override it
+static std::shared_ptr<const PathFilter> makePathFilter(const std::string& projectPath,
+        const std::vector<std::string>& ruleLines) {
+    std::shared_ptr<PathFilter> pathFilter(new PathFilter());
+    pathFilter->addRuleFile(projectPath + "/.scannerignore");
+    for (const std::string& ruleLine : ruleLines)
+        pathFilter->addRuleLine(ruleLine);
+    return pathFilter;
+}
+
+//Describe the options that decide a scan's results, a checkpoint is only resumed with the same
+static std::string checkpointSignature(const ScanOptions& options, const std::vector<std::string>& pathRules,
+        const std::string& snapshotPath, const std::string& query, double sampleFraction, int sampleFiles,
+        unsigned long sampleSeed) {
+    const BudgetLimits& limits = options.limits;
+    std::string signature = "skip-test " + std::to_string(options.skipTest) + "\n";
+    signature += "budgets " + std::to_string(limits.candidateSteps) + " " + std::to_string(limits.candidateSeconds) +
+            " " + std::to_string(limits.fileSteps) + " " + std::to_string(limits.fileSeconds) + "\n";
+    signature += "sample " + std::to_string(sampleFraction) + " " + std::to_string(sampleFiles) + " " +
+            std::to_string(sampleSeed) + "\n";
+    signature += "snapshot " + snapshotPath + "\n";
+    signature += "query " + query + "\n";
+    for (const std::string& rule : pathRules)
+        signature += "rule " + rule + "\n";
+    return signature;
+}
+
+//Scan every .java file of the project, then rescan only the files that change,
+//taking each file's old results out of the totals before adding the new ones
+static int watchProject(const ScanOptions& options, const std::vector<std::string>& pathRules) {
+    FileWatcher watcher(options.projectPath);
+    if (!watcher.isOpen()) {
+        std::cerr << "Error: could not watch " << options.projectPath << "\n";
+        return 1;
+    }
+    ScanSession session(options);
+    session.setPathFilter(makePathFilter(options.projectPath, pathRules));
+    std::map<std::string, FileResult> fileResults;
+    {
+        std::vector<FileResult> results;
+        ProgressReporter progress(0);
+        progress.start();
+        session.scanSources(watcher.getJavaFiles(), &progress, &results);
+        progress.stop();
+        for (FileResult& result : results)
+            std::swap(fileResults[result.filePath], result);
+    }
+    std::cout << "\n" << std::endl;
+    session.writeReport(std::cout, false, false, false);
+    std::cout << "\nWatching " << options.projectPath << " for changes" << std::endl;
+    std::set<std::string> changedFiles;
+    std::set<std::string> removedFiles;
+    while (watcher.waitForChanges(changedFiles, removedFiles)) {
+        ScanTotals before = session.getTotals();
+        std::cout << std::endl;
+        for (const std::string& filePath : removedFiles) {
+            std::map<std::string, FileResult>::iterator old = fileResults.find(filePath);
+            if (old == fileResults.end())
+                continue;
+            session.subtractResult(old->second);
+            session.forgetFile(filePath);
+            printFileDelta(filePath, &old->second, NULL, 0);
+            fileResults.erase(old);
+        }
+        for (const std::string& filePath : changedFiles) {
+            std::chrono::steady_clock::time_point rescanStart = std::chrono::steady_clock::now();
+            session.forgetFile(filePath);
+            FileResult result = session.scanSource(filePath);
+            std::map<std::string, FileResult>::iterator old = fileResults.find(filePath);
+            if (old != fileResults.end())
+                session.subtractResult(old->second);
+            long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - rescanStart).count();
+            printFileDelta(filePath, (old == fileResults.end()) ? NULL : &old->second, &result, milliseconds);
+            fileResults[filePath] = result;
+        }
+        printTotalsDelta(before, session.getTotals());
+    }
+    std::cerr << "Error: lost the watch on " << options.projectPath << "\n";
+    return 1;
+}
+
+//runtime_scanner snapshot [-p project_path] snapshot_file packs the project for --snapshot
+static int snapshotProject(int argc, char** argv) {
+    std::string projectPath = ScanOptions().projectPath;
+    std::string snapshotPath;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-p") && (i + 1 < argc))
+            projectPath = argv[++i];
+        else
+            snapshotPath = argv[i];
+    }
+    if (snapshotPath.empty()) {
+        std::cerr << "Usage: runtime_scanner snapshot [-p project_path] snapshot_file\n";
+        return 1;
+    }
+    int fileCount = 0;
+    if (!ProjectSnapshot::create(projectPath, snapshotPath, fileCount)) {
+        std::cerr << "Error: could not write snapshot " << snapshotPath << "\n";
+        return 1;
+    }
+    std::cout << "Packed " << fileCount << " files from " << projectPath << " into " << snapshotPath << std::endl;
+    return 0;
+}
+
+//runtime_scanner index [-p project_path] [--query pattern] index_file builds or updates the index
+//for --index, or with --query prints the lines containing the pattern in grep's format
+static int indexProject(int argc, char** argv) {
+    std::string projectPath = ScanOptions().projectPath;
+    std::string indexPath;
+    std::string pattern;
+    bool query = false;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-p") && (i + 1 < argc))
+            projectPath = argv[++i];
+        else if (!strcmp(argv[i], "--query") && (i + 1 < argc)) {
+            pattern = argv[++i];
+            query = true;
+        }
+        else
+            indexPath = argv[i];
+    }
+    if (indexPath.empty()) {
+        std::cerr << "Usage: runtime_scanner index [-p project_path] [--query pattern] index_file\n";
+        return 1;
+    }
+    if (!query) {
+        int fileCount = 0;
+        int readCount = 0;
+        if (!TrigramIndex::update(projectPath, indexPath, fileCount, readCount)) {
+            std::cerr << "Error: could not write index " << indexPath << "\n";
+            return 1;
+        }
+        std::cout << "Indexed " << fileCount << " files from " << projectPath << " into " << indexPath
+                << " (" << readCount << " read)" << std::endl;
+        return 0;
+    }
+    TrigramIndex index(indexPath);
+    if (!index.isOpen()) {
+        std::cerr << "Error: could not open index " << indexPath << "\n";
+        return 1;
+    }
+    int readCount = 0;
+    int changedCount = 0;
+    std::map<std::string, std::vector<int>> fileLines = index.query(projectPath, pattern, readCount, changedCount);
+    if (changedCount > 0)
+        std::cerr << "Warning: " << changedCount << " files changed since " << indexPath
+                << " was made and were read in full, update it with the index subcommand\n";
+    for (const std::pair<const std::string, std::vector<int>>& file : fileLines) {
+        std::string contents = FilePrefetcher::readFile(projectPath + "/" + file.first);
+        std::vector<int>::const_iterator next = file.second.begin();
+        int lineNumber = 1;
+        size_t lineStart = 0;
+        while ((lineStart < contents.size()) && (next != file.second.end())) {
+            size_t lineEnd = contents.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = contents.size();
+            if (lineNumber == *next) {
+                std::cout << "./" << file.first << ":" << lineNumber << ":"
+                        << contents.substr(lineStart, lineEnd - lineStart) << "\n";
+                next++;
+            }
+            lineStart = lineEnd + 1;
+            lineNumber++;
+        }
+    }
+    return 0;
+}
 
 int main(int argc, char** argv) {
-    //Set default file path as current directory
-    std::string projectPath = std::string("./");
-    std::string grepPath;
+    if ((argc > 1) && !strcmp(argv[1], "snapshot"))
+        return snapshotProject(argc, argv);
+    if ((argc > 1) && !strcmp(argv[1], "index"))
+        return indexProject(argc, argv);
+    //Settings for the scan, the defaults are in ScanOptions
+    ScanOptions options;
+    //Each -p adds a root, the -g files pair up with them in order or one is shared
+    std::vector<std::string> projectPaths;
+    std::vector<std::string> grepPaths;
     //Booleans for printing results
     bool printHardcode = false;
     bool printInput = false;
     bool printOther = false;
-    //Boolean to skip test files
-    bool skipTest = false;
+    //Boolean for printing scan statistics
+    bool printStats = false;
+    //Archives to list candidates from instead of scanning
+    std::vector<std::string> grepArchives;
+    //Boolean for watching the project for changes instead of reading grep input
+    bool watch = false;
+    //Sampling analyzes a fraction or a number of the files and estimates the rest
+    double sampleFraction = 0;
+    int sampleFiles = 0;
+    unsigned long sampleSeed = 1;
+    //Path rules from --exclude and --include, in .scannerignore syntax
+    std::vector<std::string> pathRules;
+    //Snapshot to read the project's files from instead of the project path
+    std::string snapshotPath;
+    //File to write each candidate's folded call stacks to
+    std::string profilePath;
+    //File keeping how long each file took, to schedule the next run from
+    std::string timingsPath;
+    //File the finished files are kept in, and whether to carry on from what it has
+    std::string checkpointPath;
+    bool resume = false;
+    //Index to find the lines containing the query in, instead of reading grep input
+    std::string indexPath;
+    std::string query;
     //Look through command line arguments
     for (int i = 1; i < argc; i++) {
         //-p [project path] gets the search path
         if (!strcmp(argv[i], "-p")) {
-            projectPath = std::string(argv[i+1]);
+            projectPaths.push_back(std::string(argv[i+1]));
         }
         //-g [grep file path] gets the grep file if not piped in
         if (!strcmp(argv[i], "-g")) {
-            grepPath = std::string(argv[i+1]);
+            grepPaths.push_back(std::string(argv[i+1]));
         }
         //-h shows hardcoded uses
         if (!strcmp(argv[i], "-h")) {
@@ -74,7 +414,94 @@ int main(int argc, char** argv) {
         }
         //-t skip test files
         if (!strcmp(argv[i], "-t")) {
-            skipTest = true;
+            options.skipTest = true;
+        }
+        //-s shows scan statistics
+        if (!strcmp(argv[i], "-s")) {
+            printStats = true;
+        }
+        //--max-memory [size] bounds memory use by streaming and spilling to disk
+        if (!strcmp(argv[i], "--max-memory")) {
+            if (!parseMemorySize(std::string(argv[i+1]), options.maxMemory)) {
+                std::cerr << "Error: --max-memory takes a size like 512M or 2G, not " << argv[i+1] << "\n";
+                return 1;
+            }
+        }
+        //--prefetch [depth] sets how many files are read ahead, 0 reads synchronously
+        if (!strcmp(argv[i], "--prefetch")) {
+            options.prefetchDepth = std::max(0, atoi(argv[i+1]));
+        }
+        //-j [jobs] analyzes files on several threads, splitting files with many candidates between them
+        if (!strcmp(argv[i], "-j")) {
+            options.jobs = std::max(1, atoi(argv[i+1]));
+        }
+        //--candidate-budget [steps|time] gives up on a candidate after that many steps or seconds
+        if (!strcmp(argv[i], "--candidate-budget")) {
+            if (!parseBudget(std::string(argv[i+1]), options.limits.candidateSteps, options.limits.candidateSeconds)) {
+                std::cerr << "Error: --candidate-budget takes a number of steps or a time like 2s or 500ms, not "
+                        << argv[i+1] << "\n";
+                return 1;
+            }
+        }
+        //--file-budget [steps|time] gives up on the rest of a file's candidates the same way
+        if (!strcmp(argv[i], "--file-budget")) {
+            if (!parseBudget(std::string(argv[i+1]), options.limits.fileSteps, options.limits.fileSeconds)) {
+                std::cerr << "Error: --file-budget takes a number of steps or a time like 2s or 500ms, not "
+                        << argv[i+1] << "\n";
+                return 1;
+            }
+        }
+        //--grep-archive [archive] prints the candidates inside an archive as grep lines
+        if (!strcmp(argv[i], "--grep-archive")) {
+            grepArchives.push_back(std::string(argv[i+1]));
+        }
+        //--watch scans the project and then rescans the files that change
+        if (!strcmp(argv[i], "--watch")) {
+            watch = true;
+        }
+        //--exclude [glob] skips matching files before they are read, --include [glob] takes them back
+        if (!strcmp(argv[i], "--exclude")) {
+            pathRules.push_back(std::string(argv[i+1]));
+        }
+        if (!strcmp(argv[i], "--include")) {
+            pathRules.push_back("!" + std::string(argv[i+1]));
+        }
+        //--sample [fraction] or --sample-files [count] estimates the totals from some of the files
+        if (!strcmp(argv[i], "--sample")) {
+            sampleFraction = atof(argv[i+1]);
+        }
+        if (!strcmp(argv[i], "--sample-files")) {
+            sampleFiles = std::max(0, atoi(argv[i+1]));
+        }
+        //--seed [number] picks a different sample, the same seed always picks the same files
+        if (!strcmp(argv[i], "--seed")) {
+            sampleSeed = strtoul(argv[i+1], NULL, 10);
+        }
+        //--snapshot [file] reads source files from a snapshot made by the snapshot subcommand
+        if (!strcmp(argv[i], "--snapshot")) {
+            snapshotPath = std::string(argv[i+1]);
+        }
+        //--profile-candidates [file] times each candidate's calls for a flame graph
+        if (!strcmp(argv[i], "--profile-candidates")) {
+            profilePath = std::string(argv[i+1]);
+        }
+        //--timings [file] schedules -j from the file's timings and saves this run's to it
+        if (!strcmp(argv[i], "--timings")) {
+            timingsPath = std::string(argv[i+1]);
+        }
+        //--checkpoint [file] keeps finished files as it goes, --resume skips the ones it has
+        if (!strcmp(argv[i], "--checkpoint")) {
+            checkpointPath = std::string(argv[i+1]);
+        }
+        if (!strcmp(argv[i], "--resume")) {
+            resume = true;
+        }
+        //--index [file] --query [pattern] takes the candidates from an index made by the index subcommand
+        if (!strcmp(argv[i], "--index")) {
+            indexPath = std::string(argv[i+1]);
+        }
+        if (!strcmp(argv[i], "--query")) {
+            query = std::string(argv[i+1]);
         }
         //--help and -? show how to use runtime_scanner
         if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-?")) {
@@ -84,196 +511,232 @@ int main(int argc, char** argv) {
             std::cout << "\t-i | display uses with function input" << std::endl;
             std::cout << "\t-o | display other uses" << std::endl;
             std::cout << "\t-t | skip test files" << std::endl;
+            std::cout << "\t-s | display scan statistics" << std::endl;
+            std::cout << "\t-j [jobs] | number of threads, files with many candidates are split between them" << std::endl;
+            std::cout << "\t--max-memory [size] | stream input and spill uses to disk past size (e.g. 512M)" << std::endl;
+            std::cout << "\t--prefetch [depth] | number of files read ahead of analysis (default 8)" << std::endl;
+            std::cout << "\t--candidate-budget [steps|time] | leave a candidate unresolved past e.g. 100000 or 2s" << std::endl;
+            std::cout << "\t--file-budget [steps|time] | leave the rest of a file unresolved past e.g. 1000000 or 30s" << std::endl;
+            std::cout << "\t--grep-archive [archive] | print .exec( lines of a .srcjar/.zip as grep input" << std::endl;
+            std::cout << "\t--watch | scan the project, then rescan files as they change and print what changed" << std::endl;
+            std::cout << "\t--exclude [glob] | skip files matching the glob without reading them (e.g. '**/generated/')" << std::endl;
+            std::cout << "\t--include [glob] | scan files matching the glob even if an earlier rule excluded them" << std::endl;
+            std::cout << "\t--sample [fraction] | estimate the totals from a stratified sample of the files (e.g. 0.05)" << std::endl;
+            std::cout << "\t--sample-files [count] | estimate the totals from a sample of this many files" << std::endl;
+            std::cout << "\t--seed [number] | seed for picking the sample (default 1)" << std::endl;
+            std::cout << "\t--snapshot [file] | read source files from a snapshot instead of the project path" << std::endl;
+            std::cout << "\t--profile-candidates [file] | write folded call stacks per candidate and list the slowest" << std::endl;
+            std::cout << "\t--timings [file] | order files for -j by the timings of the last run, then save this run's" << std::endl;
+            std::cout << "\t--checkpoint [file] | keep finished files in the file as the scan goes" << std::endl;
+            std::cout << "\t--resume | carry on from the --checkpoint file, skipping the files it has" << std::endl;
+            std::cout << "\t--index [file] | find candidates in an index made by the index subcommand, with --query" << std::endl;
+            std::cout << "\t--query [pattern] | the text a candidate line contains (e.g. '.exec(')" << std::endl;
+            std::cout << "\tsnapshot [-p project path] [file] | pack the project's .java files into a snapshot" << std::endl;
+            std::cout << "\tindex [-p project path] [--query pattern] [file] | build or update a trigram index,"
+                    << " or print the lines containing the pattern" << std::endl;
+        }
+    }
+    
+    //Listing archive candidates replaces the scan, its output is grep input
+    if (!grepArchives.empty()) {
+        for (const std::string& archivePath : grepArchives) {
+            if (!grepArchive(archivePath)) {
+                std::cerr << "Error: could not read archive " << archivePath << "\n";
+                return 1;
+            }
+        }
+        return 0;
+    }
+    
+    if (projectPaths.empty())
+        projectPaths.push_back(options.projectPath);
+    options.projectPath = projectPaths[0];
+    
+    //A snapshot stands in for the one project path, the files are all mapped up front
+    std::shared_ptr<ProjectSnapshot> snapshot;
+    if (!snapshotPath.empty()) {
+        if ((projectPaths.size() > 1) || watch) {
+            std::cerr << "Error: --snapshot takes the place of a single project path, without --watch\n";
+            return 1;
+        }
+        snapshot.reset(new ProjectSnapshot(snapshotPath));
+        if (!snapshot->isOpen()) {
+            std::cerr << "Error: could not open snapshot " << snapshotPath << "\n";
+            return 1;
+        }
+    }
+    if (resume && checkpointPath.empty()) {
+        std::cerr << "Error: --resume needs the --checkpoint file to resume from\n";
+        return 1;
+    }
+    if (!checkpointPath.empty() && watch) {
+        std::cerr << "Error: --checkpoint can't be used with --watch\n";
+        return 1;
+    }
+    //An index finds the candidates in place of grep input, for the one project path
+    std::map<std::string, std::vector<int>> indexLines;
+    if (!indexPath.empty() || !query.empty()) {
+        if (indexPath.empty() || query.empty()) {
+            std::cerr << "Error: --index and --query are used together\n";
+            return 1;
+        }
+        if ((projectPaths.size() > 1) || !grepPaths.empty() || watch) {
+            std::cerr << "Error: --index takes the place of grep input for a single project path, without --watch\n";
+            return 1;
         }
+        TrigramIndex index(indexPath);
+        if (!index.isOpen()) {
+            std::cerr << "Error: could not open index " << indexPath << "\n";
+            return 1;
+        }
+        std::chrono::steady_clock::time_point queryStart = std::chrono::steady_clock::now();
+        int readCount = 0;
+        int changedCount = 0;
+        indexLines = index.query(options.projectPath, query, readCount, changedCount);
+        long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - queryStart).count();
+        size_t lineCount = 0;
+        for (const std::pair<const std::string, std::vector<int>>& file : indexLines)
+            lineCount += file.second.size();
+        std::cerr << "Query found " << lineCount << " lines in " << indexLines.size() << " files, reading "
+                << readCount << " of " << index.getFileCount() << " (" << milliseconds << " ms)\n";
+        if (changedCount > 0)
+            std::cerr << "Warning: " << changedCount << " files changed since " << indexPath
+                    << " was made and were read in full, update it with the index subcommand\n";
+    }
+    //Watching finds its own candidates, so it doesn't take grep input. It rescans the
+    //files that change, so it keeps the indexes of the recent ones, grep input never repeats a file
+    if (watch) {
+        options.cachedFiles = 8;
+        return watchProject(options, pathRules);
     }
     
-    //Open a grep parser for the grep file
-    GrepParser grepParser;
-    //If a grep file path was specified, use it
-    if (!grepPath.empty()) {
-        grepParser.setInput(grepPath);
+    //Several roots either each have a grep file or all share the one grep input
+    if ((grepPaths.size() > 1) && (grepPaths.size() != projectPaths.size())) {
+        std::cerr << "Error: " << grepPaths.size() << " grep files for " << projectPaths.size() << " project paths\n";
+        return 1;
     }
     //If no grep file and no piped input, output error and exit
-    else if (isatty(fileno(stdin))) {
+    if (grepPaths.empty() && indexPath.empty() && isatty(fileno(stdin))) {
         std::cerr << "Error: no grep input given, exiting\n";
         return 1;
     }
+    //Piped input can only be read once, so keep it for every root
+    std::string sharedInput;
+    if (grepPaths.empty() && (projectPaths.size() > 1))
+        sharedInput.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    //Files identical between roots are analyzed once and their results reused
+    std::shared_ptr<ContentCache> contentCache;
+    if (projectPaths.size() > 1)
+        contentCache.reset(new ContentCache());
+    //One profile covers every root, written out once they're all scanned
+    std::shared_ptr<CandidateProfiler> profiler;
+    if (!profilePath.empty())
+        profiler.reset(new CandidateProfiler());
+    //With several threads files are handed out longest first, by size or the last run's timings
+    std::shared_ptr<FileScheduler> scheduler(new FileScheduler());
+    if (!timingsPath.empty())
+        scheduler->loadTimings(timingsPath);
+    //Only a scan with the same options gives the same results, so they go in the checkpoint
+    std::shared_ptr<ScanCheckpoint> checkpoint;
+    if (!checkpointPath.empty()) {
+        std::string signature = checkpointSignature(options, pathRules, snapshotPath, query,
+                sampleFraction, sampleFiles, sampleSeed);
+        std::string error;
+        checkpoint.reset(new ScanCheckpoint());
+        if (!checkpoint->open(checkpointPath, signature, resume, error)) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    }
     
-    //Get the map between file paths and sets of target lines
-    std::map<std::string, std::vector<int>> fileLines = grepParser.parseInput();
-    //Create some file counting integers for display at the end
-    int runtimeFileCount = 0;
-    int currentFileCount = 0;
-    int totalFileCount = fileLines.size();
-    int testFileCount = 0;
-    //Create some function counting integers for display at the end
-    int runtimeFunctionCount = 0;
-    int inputFunctionCount = 0;
-    int hardcodedFunctionCount = 0;
-    int totalFunctionCount = 0;
-    //Create maps to keep track of the input parameter types
-    std::map<std::string,int> typeCounts;
-    std::map<std::string,int> typeHardcoded;
-    std::map<std::string,int> typeInput;
-    //Create vectors to keep track of usage types
-    std::vector<std::string> hardcodedUses;
-    std::vector<std::string> inputUses;
-    std::vector<std::string> otherUses;
-    
-    //Iterate through all of the pairs in the grep map
-    for (auto const& file : fileLines) {
-        //file.first is the file path
-        //file.second is the vector of line numbers
-        //Increment the file count, add number of lines, and print progress
-        currentFileCount += 1;
-        totalFunctionCount += file.second.size();
-        std::cout << "\rCurrent Progress: File " << currentFileCount << "/" << totalFileCount << std::flush;
-        //Open up a new JavaParser for the current file
-        JavaParser jp(projectPath + "/" + file.first);
-        //Count the number of files and file paths containing "test"
-        if (Util::regexFind(file.first, "[tT][eE][sS][tT]") != std::string::npos) {
-            if (skipTest)
-                continue;
-            testFileCount += 1;
-        }
-        //Iterate through the list of target lines
-        for (int lineNo : file.second) {
-            //Get the full line up to the semicolon
-            std::string statement = jp.getFullStatement(lineNo);
-            //Check if the line explicitly calls Runtime.getRuntim().exec()
-            bool hasRuntime = (statement.find("Runtime.getRuntime().exec(") != std::string::npos);
-            bool hasProcess = false;
-            //Otherwise we want to see if .exec( returns a Process
-            //Use a regex to see if there is an assignment on the left side
-            int nameStart = Util::regexFind(statement, "\\w+ *= *.*\\.exec\\(");
-            //If the search was successful
-            if (nameStart != std::string::npos) {
-                //Find the end of the name being a space or an equals sign
-                int nameEnd = Util::regexFind(statement, "( |=)", nameStart);
-                //If there's no end then that's pretty weird
-                if (nameEnd != std::string::npos) {
-                    //Get the name of the lvalue and check if its type is "Process"
-                    std::string name = statement.substr(nameStart, nameEnd - nameStart);
-                    hasProcess = (jp.findType(name, jp.getFunctionName(lineNo)) == "Process");
-                }   
-            }
-            //If neither is true, continue to the next candidate
-            if (!hasRuntime && !hasProcess)
-                continue;
-            //If the line is commented than continue
-            else if (jp.isCommented(lineNo))
-                continue;
-            //Add to the number of functions actually containing runtime
-            runtimeFileCount += 1;
-            runtimeFunctionCount += 1;
-            //Set initial values for hardcoded and input, we'll look for opposite
-            bool hardcoded = true;
-            bool hasInput = false;
-            //Iterate through all of the inputs to .exec()
-            for (const std::string& s : jp.parseRecursively("exec", lineNo)) {
-                //Get the name of the function at the line
-                std::string functionName = jp.getFunctionName(lineNo);
-                //Get the type of the string s in the function
-                std::string type = jp.findType(s, functionName);
-                //If type is missing, it might be a class member
-                if (type.empty()) {
-                    type = jp.findMemberType(s);
-                }
-                //Check if type is already in typeCounts, add it if not
-                if (!typeCounts.count(type))
-                    typeCounts[type] = 1;
-                //If it's already there just increment it
-                else
-                    typeCounts[type] += 1;
-                //If jp is not hardcoded, then the whole line isn't
-                if (!jp.isHardcoded(s, functionName)) {
-                    hardcoded = false;
-                }
-                //Otherwise add it to typeHardcoded like typeCounts
-                else {
-                    if (!typeHardcoded.count(type))
-                        typeHardcoded[type] = 1;
-                    else
-                        typeHardcoded[type] += 1;
-                }
-                //If s is an input to the function surrounding .exec(
-                //Add it to typeInput like typeCounts
-                if (jp.isInput(s, functionName)) {
-                    hasInput = true;
-                    if (!typeInput.count(type))
-                        typeInput[type] = 1;
-                    else
-                        typeInput[type] += 1;
-                }
-            }
-            //Keep track of the usages for printing with the flags
-            std::string usage = file.first + ": " + std::to_string(lineNo) + ":\n" + statement;
-            //Keep track of how many functions have input and how many are hardcoded
-            if (hasInput) {
-                inputFunctionCount += 1;
-                inputUses.push_back(usage);
-            }
-            else if (hardcoded) {
-                hardcodedFunctionCount += 1;
-                hardcodedUses.push_back(usage);
-            }
-            else {
-                otherUses.push_back(usage);
+    //Set when streamed grep input wasn't grouped by file, the report is then missing lines
+    bool ungroupedInput = false;
+    for (int i = 0; i < projectPaths.size(); i++) {
+        //Open a grep parser for the grep file
+        GrepParser grepParser;
+        //If a grep file path was specified, use it
+        if (!grepPaths.empty())
+            grepParser.setInput(grepPaths[(grepPaths.size() == 1) ? 0 : i]);
+        else if (projectPaths.size() > 1)
+            grepParser.setInputText(sharedInput);
+        //Each root gets the same report it would get on its own
+        if (projectPaths.size() > 1)
+            std::cout << ((i > 0) ? "\n" : "") << "==> " << projectPaths[i] << " <==" << std::endl;
+        //The session does the scanning, this is just the command line around it
+        ScanOptions rootOptions = options;
+        rootOptions.projectPath = projectPaths[i];
+        ScanSession session(rootOptions);
+        session.setContentCache(contentCache);
+        session.setSnapshot(snapshot);
+        session.setPathFilter(makePathFilter(projectPaths[i], pathRules));
+        session.setProfiler(profiler);
+        session.setScheduler(scheduler);
+        session.setCheckpoint(checkpoint);
+        //Progress is drawn from its own thread, the session tells it the total when it knows
+        ProgressReporter progress(0);
+        progress.start();
+        //A sample needs the whole grep input to pick from, even with a memory budget
+        if ((sampleFraction > 0) || (sampleFiles > 0)) {
+            SampleEstimator estimator(indexPath.empty() ? grepParser.parseInput() : indexLines,
+                    sampleFraction, sampleFiles, sampleSeed);
+            std::vector<FileResult> results;
+            session.scanFiles(estimator.getSample(), &progress, &results);
+            progress.stop();
+            for (const FileResult& result : results)
+                estimator.addResult(result);
+            std::cout << "\n" << std::endl;
+            estimator.writeReport(std::cout);
+            std::cout << "\nSampled Files\n" << std::endl;
+        }
+        else if (!indexPath.empty()) {
+            session.scanFiles(indexLines, &progress, NULL);
+            progress.stop();
+            std::cout << "\n" << std::endl;
+        }
+        else {
+            session.scanGrep(grepParser, &progress);
+            progress.stop();
+            //Add an endline for the \r
+            std::cout << "\n" << std::endl;
+            //Streamed input has to list each file's lines together, later runs were left out
+            if (grepParser.getSkippedRunCount() > 0) {
+                std::cerr << "Error: grep input lists " << grepParser.getSkippedRunCount() << " files again after"
+                        << " other files, their later lines were skipped; sort it or leave out --max-memory\n";
+                ungroupedInput = true;
             }
+            if (grepParser.getUncheckedFileCount() > 0)
+                std::cerr << "Warning: grep input lists too many files to check them all for being listed again, "
+                        << grepParser.getUncheckedFileCount() << " files were not checked\n";
         }
+        session.writeReport(std::cout, printHardcode, printInput, printOther);
+        if (session.getTotals().snapshotMissCount > 0)
+            std::cerr << "Warning: " << session.getTotals().snapshotMissCount << " files in the grep input"
+                    << " were not in the snapshot " << snapshotPath << ", it may be out of date\n";
+        //Print the scan statistics
+        if (printStats)
+            session.writeStatistics(std::cout);
     }
-    //Add an endline for the \r
-    std::cout << "\n" << std::endl;
-    //Print the number omitted due to not being Runtime.exec()
-    std::cout << totalFunctionCount << " candidates given, ";
-    std::cout << (totalFunctionCount - runtimeFunctionCount);
-    std::cout << " omitted for being commented or lacking Runtime" << std::endl;
-    //Print the total, hardcoded, and containing input
-    std::cout << "Out of " << runtimeFunctionCount << " uses: ";
-    std::cout << hardcodedFunctionCount << " hardcoded, ";
-    std::cout << inputFunctionCount << " from function input, ";
-    std::cout << (runtimeFunctionCount - hardcodedFunctionCount - inputFunctionCount);
-    std::cout << " other" << std::endl;
-    //Print the number of "test" files if they weren't skipped
-    if (!skipTest) {
-        std::cout << testFileCount << "/" << totalFileCount;
-        std::cout << " file paths contain \"test\"" << std::endl;
-    }
-    //Print header for the function table
-    std::cout << "\nExec Input Table\n" << std::endl;
-    //Print all of the types, their total/hardcoded/input count
-    std::cout << std::left << std::setw(20) << "Variable Type" << std::right << " | ";
-    std::cout << std::left << std::setw(7) << "Total" << std::right << " | ";
-    std::cout << std::left << std::setw(9) << "Hardcoded" << std::right << " | ";
-    std::cout << std::left << std::setw(7) << "Input" << std::endl;
-    std::cout << std::string(48, '-') << std::endl;
-    //Look through typeCount, typeHardcoded, typeInput and print values
-    for (auto const& x : typeCounts) {
-        std::cout << std::left << std::setw(20) << x.first << std::right << " | ";
-        std::cout << std::left << std::setw(7) << x.second << std::right << " | ";
-        std::cout << std::left << std::setw(9) << typeHardcoded[x.first] << " | ";
-        std::cout << std::left << std::setw(7) << typeInput[x.first] << std::endl; 
-    }
-    
-    //Print all of the hardcoded uses
-    if (printHardcode) {
-        std::cout << "\nHardcoded Uses:" << std::endl;
-        for (const std::string& s : hardcodedUses)
-            std::cout << s << std::endl;
+    if (checkpoint) {
+        if (!checkpoint->flush()) {
+            std::cerr << "Error: could not write checkpoint " << checkpointPath << "\n";
+            return 1;
+        }
+        if (resume)
+            std::cerr << "Resumed " << checkpoint->getResumedCount() << " files from " << checkpointPath << "\n";
     }
-    //Print all of the input uses
-    if (printInput) {
-        std::cout << "\nInput Uses:" << std::endl;
-        for (const std::string& s : inputUses)
-            std::cout << s << std::endl;
+    if (!timingsPath.empty() && !scheduler->saveTimings(timingsPath)) {
+        std::cerr << "Error: could not write timings " << timingsPath << "\n";
+        return 1;
     }
-    //Print all of the other uses
-    if (printOther) {
-        std::cout << "\nOther Uses:" << std::endl;
-        for (const std::string& s : otherUses)
-            std::cout << s << std::endl;
+    if (profiler) {
+        profiler->writeSlowest(std::cout, slowestCandidateCount);
+        if (!profiler->writeFoldedStacks(profilePath)) {
+            std::cerr << "Error: could not write profile " << profilePath << "\n";
+            return 1;
+        }
     }
     
-    return 0;
+    return ungroupedInput ? 1 : 0;
 }
 